@@ -0,0 +1,122 @@
+// Blend kernel microbenchmark: blends random ARGB8888 spans with every mode
+// at every SIMD level the CPU supports and prints megapixels per second as
+// one JSON document.
+//
+//   spark_blend_bench [--pixels N] [--seconds S] [--output FILE]
+#include "spark_graphics/blend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char* level_name(SparkSimdLevel level) {
+    switch (level) {
+        case SPARK_SIMD_SSE2: return "sse2";
+        case SPARK_SIMD_AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t next_random(uint32_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// Mostly translucent with some fully opaque and fully transparent pixels,
+// like sprite edges
+static void fill(uint32_t* pixels, int count, uint32_t seed) {
+    for (int i = 0; i < count; i++) {
+        uint32_t pixel = next_random(&seed);
+        switch (pixel & 7) {
+            case 0: pixel &= 0x00FFFFFF; break;
+            case 1: pixel |= 0xFF000000; break;
+            default: break;
+        }
+        pixels[i] = pixel;
+    }
+}
+
+int main(int argc, char** argv) {
+    int pixels = 1 << 20;
+    double seconds = 0.25;
+    const char* output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--pixels") == 0 && value) {
+            pixels = atoi(value);
+            i++;
+        } else if (strcmp(argv[i], "--seconds") == 0 && value) {
+            seconds = atof(value);
+            i++;
+        } else if (strcmp(argv[i], "--output") == 0 && value) {
+            output = value;
+            i++;
+        } else {
+            fprintf(stderr, "usage: %s [--pixels N] [--seconds S] [--output FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (pixels <= 0 || seconds <= 0.0) {
+        fprintf(stderr, "blend bench: invalid options\n");
+        return 1;
+    }
+
+    uint32_t* src = malloc((size_t)pixels * 4);
+    uint32_t* dst = malloc((size_t)pixels * 4);
+    uint32_t* background = malloc((size_t)pixels * 4);
+    if (!src || !dst || !background) {
+        fprintf(stderr, "blend bench: out of memory\n");
+        return 1;
+    }
+    fill(src, pixels, 0x12345678u);
+    fill(background, pixels, 0x9E3779B9u);
+
+    FILE* out = output ? fopen(output, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "blend bench: cannot write %s\n", output);
+        return 1;
+    }
+
+    SparkSimdLevel best = spark_graphics_get_simd_level();
+    fprintf(out, "{\"pixels\":%d,\"detected\":\"%s\",\"results\":[", pixels, level_name(best));
+
+    int written = 0;
+    for (int level = SPARK_SIMD_SCALAR; level <= SPARK_SIMD_AVX2; level++) {
+        if (!spark_graphics_set_simd_level((SparkSimdLevel)level)) continue;
+
+        for (int mode = 0; mode < SPARK_BLEND_MODE_COUNT; mode++) {
+            // Each pass restores dst so every pass blends the same data
+            int passes = 0;
+            double blend_time = 0.0;
+            while (blend_time < seconds) {
+                memcpy(dst, background, (size_t)pixels * 4);
+                double start = now();
+                spark_graphics_blend_span((SparkBlendMode)mode, dst, src, pixels);
+                blend_time += now() - start;
+                passes++;
+            }
+
+            double mpix = (double)pixels * passes / blend_time / 1e6;
+            fprintf(out, "%s\n{\"mode\":\"%s\",\"simd\":\"%s\",\"passes\":%d,\"mpix_per_sec\":%.1f}",
+                    written++ > 0 ? "," : "", spark_graphics_blend_mode_name((SparkBlendMode)mode),
+                    level_name((SparkSimdLevel)level), passes, mpix);
+        }
+    }
+    fprintf(out, "\n]}\n");
+
+    if (out != stdout) fclose(out);
+    spark_graphics_set_simd_level(best);
+    free(src);
+    free(dst);
+    free(background);
+    return 0;
+}
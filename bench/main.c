@@ -0,0 +1,262 @@
+// Spark2D benchmark: runs each scene headlessly in its own process and
+// prints one JSON document with fps, per-phase timings and peak memory.
+//
+//   spark_bench [--scene NAME] [--count N] [--frames N] [--warmup N]
+//               [--size WxH] [--output FILE]
+#include "spark2d.h"
+#include "scenes.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+static struct {
+    const char* scene;
+    int count;
+    unsigned long frames;
+    unsigned long warmup;
+    int width;
+    int height;
+    const char* output;
+} options = {
+    .frames = 300,
+    .warmup = 30,
+    .width = 1280,
+    .height = 720
+};
+
+static struct {
+    const BenchScene* scene;
+    int count;
+    double start;
+} run;
+
+static void bench_load(void) {
+    run.scene->load(run.count);
+}
+
+static void bench_update(float dt) {
+    run.scene->update(dt);
+
+    // Measure steady state only
+    if (spark_get_frame_count() == options.warmup) {
+        spark_stats_reset();
+        spark_render_reset_stats();
+        run.start = spark_timer_get_time();
+    }
+}
+
+static const char* render_mode_name(SparkRenderMode mode) {
+    switch (mode) {
+        case SPARK_RENDER_PARTIAL: return "partial";
+        case SPARK_RENDER_FULL: return "full";
+        default: return "direct";
+    }
+}
+
+static void write_result(FILE* out) {
+    double seconds = spark_timer_get_time() - run.start;
+    unsigned long frames = spark_get_frame_count() - options.warmup;
+
+    SparkStats stats;
+    spark_stats_get(&stats);
+    SparkRenderStats render;
+    spark_render_get_stats(&render);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    lv_mem_monitor_t mem;
+    lv_mem_monitor(&mem);
+
+    fprintf(out, "{\"scene\":\"%s\",\"count\":%d,\"frames\":%lu,\"seconds\":%.4f,\"fps\":%.2f,",
+            run.scene->name, run.count, frames, seconds,
+            seconds > 0.0 ? frames / seconds : 0.0);
+
+    fprintf(out, "\"ms\":{");
+    for (int phase = 0; phase < SPARK_STATS_PHASE_COUNT; phase++) {
+        const SparkStatsPhaseSummary* p = &stats.phases[phase];
+        fprintf(out, "%s\"%s\":{\"mean\":%.4f,\"p50\":%.4f,\"p95\":%.4f,\"p99\":%.4f,\"max\":%.4f}",
+                phase > 0 ? "," : "", spark_stats_phase_name((SparkStatsPhase)phase),
+                (double)p->mean, (double)p->p50, (double)p->p95, (double)p->p99, (double)p->max);
+    }
+    fprintf(out, "},");
+
+    fprintf(out, "\"render\":{\"frames\":%lu,\"avg_pixels\":%.0f,\"avg_flush_bytes\":%.0f,"
+                 "\"avg_areas_merged\":%.2f,\"buffer_bytes\":%zu},",
+            render.frames, (double)render.avg_rendered_pixels, (double)render.avg_flush_bytes,
+            (double)render.avg_areas_merged, render.buffer_bytes);
+
+    // ru_maxrss is in kilobytes on Linux
+    fprintf(out, "\"memory\":{\"peak_rss_bytes\":%ld,\"lvgl_peak_bytes\":%lu}}",
+            usage.ru_maxrss * 1024L, (unsigned long)mem.max_used);
+}
+
+// Child process: one scene, one fresh LVGL instance
+static int run_scene(const BenchScene* scene, int count, int fd) {
+    // Keep library chatter out of the JSON on stdout
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull >= 0) {
+        dup2(devnull, STDOUT_FILENO);
+        close(devnull);
+    }
+
+    run.scene = scene;
+    run.count = count;
+
+    spark_set_backend(SPARK_BACKEND_HEADLESS);
+    spark_set_max_frames(options.warmup + options.frames);
+    if (!spark_init("Spark2D Bench", options.width, options.height)) {
+        fprintf(stderr, "bench: spark_init failed for %s\n", scene->name);
+        return 1;
+    }
+    spark_timer_set_target_fps(0);
+
+    spark_set_load(bench_load);
+    spark_set_update(bench_update);
+    spark_run();
+
+    FILE* out = fdopen(fd, "w");
+    if (!out) return 1;
+    write_result(out);
+    fclose(out);
+
+    spark_quit();
+    return 0;
+}
+
+// Runs the scene in a child so peak memory and LVGL state start clean
+static char* fork_scene(const BenchScene* scene, int count) {
+    int fds[2];
+    if (pipe(fds) != 0) return NULL;
+
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return NULL;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        _exit(run_scene(scene, count, fds[1]));
+    }
+
+    close(fds[1]);
+    size_t size = 0;
+    size_t capacity = 4096;
+    char* result = malloc(capacity);
+    ssize_t n;
+    while (result && (n = read(fds[0], result + size, capacity - size - 1)) > 0) {
+        size += (size_t)n;
+        if (capacity - size <= 1) {
+            capacity *= 2;
+            char* grown = realloc(result, capacity);
+            if (!grown) free(result);
+            result = grown;
+        }
+    }
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!result || size == 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "bench: scene %s failed\n", scene->name);
+        free(result);
+        return NULL;
+    }
+    result[size] = '\0';
+    return result;
+}
+
+static bool parse_args(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--help") == 0 || !value) {
+            fprintf(stderr, "usage: %s [--scene NAME] [--count N] [--frames N] [--warmup N] "
+                            "[--size WxH] [--output FILE]\nscenes:", argv[0]);
+            for (int s = 0; s < bench_scene_count; s++) {
+                fprintf(stderr, " %s", bench_scenes[s].name);
+            }
+            fprintf(stderr, "\n");
+            return false;
+        }
+
+        if (strcmp(arg, "--scene") == 0) {
+            options.scene = value;
+        } else if (strcmp(arg, "--count") == 0) {
+            options.count = atoi(value);
+        } else if (strcmp(arg, "--frames") == 0) {
+            options.frames = strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--warmup") == 0) {
+            options.warmup = strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--size") == 0) {
+            if (sscanf(value, "%dx%d", &options.width, &options.height) != 2) {
+                fprintf(stderr, "bench: invalid size %s\n", value);
+                return false;
+            }
+        } else if (strcmp(arg, "--output") == 0) {
+            options.output = value;
+        } else {
+            fprintf(stderr, "bench: unknown option %s\n", arg);
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (!parse_args(argc, argv)) return 2;
+
+    if (options.scene && !bench_find_scene(options.scene)) {
+        fprintf(stderr, "bench: unknown scene %s\n", options.scene);
+        return 2;
+    }
+
+    FILE* out = stdout;
+    if (options.output) {
+        out = fopen(options.output, "w");
+        if (!out) {
+            fprintf(stderr, "bench: cannot write %s\n", options.output);
+            return 1;
+        }
+    }
+
+    // Environment overrides (SPARK_RENDER_MODE, SPARK_DRAW_UNITS) are read by
+    // spark_init in each child; report what they resolve to
+    const char* mode = getenv("SPARK_RENDER_MODE");
+    const char* units = getenv("SPARK_DRAW_UNITS");
+    fprintf(out, "{\"width\":%d,\"height\":%d,\"render_mode\":\"%s\",\"draw_units\":%d,"
+                 "\"max_draw_units\":%d,\"scenes\":[",
+            options.width, options.height,
+            mode ? mode : render_mode_name(spark_get_render_mode()),
+            units && atoi(units) > 0 ? atoi(units) : spark_get_max_draw_units(),
+            spark_get_max_draw_units());
+
+    int failures = 0;
+    int written = 0;
+    for (int i = 0; i < bench_scene_count; i++) {
+        const BenchScene* scene = &bench_scenes[i];
+        if (options.scene && strcmp(options.scene, scene->name) != 0) continue;
+
+        int count = options.count > 0 ? options.count : scene->default_count;
+        fprintf(stderr, "bench: %s (%d)\n", scene->name, count);
+
+        char* result = fork_scene(scene, count);
+        if (!result) {
+            failures++;
+            continue;
+        }
+        fprintf(out, "%s\n%s", written++ > 0 ? "," : "", result);
+        free(result);
+    }
+    fprintf(out, "\n]}\n");
+
+    if (out != stdout) fclose(out);
+    return failures > 0 ? 1 : 0;
+}
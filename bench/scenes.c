@@ -0,0 +1,447 @@
+// scenes.c
+#include "scenes.h"
+#include "spark2d.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef BENCH_ASSET_DIR
+#define BENCH_ASSET_DIR "../examples/assets"
+#endif
+
+#define MAX_ITEMS 4096
+
+// Every scene moves or changes all of its items every frame
+typedef struct {
+    float x, y;
+    float vx, vy;
+    float size;
+    float phase;
+} Item;
+
+static struct {
+    int count;
+    int width;
+    int height;
+    float time;
+    unsigned long frame;
+    uint32_t seed;
+    Item items[MAX_ITEMS];
+    lv_obj_t* objects[MAX_ITEMS];
+    SparkLabel* labels[MAX_ITEMS];
+    SparkImage* images[MAX_ITEMS];
+    SparkButton* buttons[MAX_ITEMS];
+    SparkContainer* container;
+    SparkDrawList* draw_list;
+    SparkPointCloud* point_cloud;
+    SparkSpriteBatch* sprite_batch;
+    SparkCanvas* canvas;
+    SparkSdfFont* sdf_font;
+    SparkSdfText* sdf_texts[MAX_ITEMS];
+    float xy[MAX_ITEMS * 2];
+} scene = {0};
+
+// Deterministic so runs stay comparable
+static float random_float(float min, float max) {
+    scene.seed = scene.seed * 1664525u + 1013904223u;
+    return min + (max - min) * (float)(scene.seed >> 8) / (float)(1u << 24);
+}
+
+static void init_items(int count, float min_size, float max_size) {
+    lv_obj_t* screen = lv_screen_active();
+    scene.width = lv_obj_get_width(screen);
+    scene.height = lv_obj_get_height(screen);
+    scene.count = count < MAX_ITEMS ? count : MAX_ITEMS;
+    scene.seed = 12345;
+    scene.time = 0.0f;
+    scene.frame = 0;
+
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        item->size = random_float(min_size, max_size);
+        item->x = random_float(0.0f, scene.width - item->size);
+        item->y = random_float(0.0f, scene.height - item->size);
+        item->vx = random_float(-120.0f, 120.0f);
+        item->vy = random_float(-120.0f, 120.0f);
+        item->phase = random_float(0.0f, 6.28f);
+    }
+}
+
+static void move_item(Item* item, float dt) {
+    item->x += item->vx * dt;
+    item->y += item->vy * dt;
+    if (item->x < 0.0f || item->x + item->size > scene.width) item->vx = -item->vx;
+    if (item->y < 0.0f || item->y + item->size > scene.height) item->vy = -item->vy;
+}
+
+static void set_random_color(void) {
+    spark_graphics_set_color(random_float(0.2f, 1.0f), random_float(0.2f, 1.0f),
+                             random_float(0.2f, 1.0f));
+}
+
+// Shapes
+
+static void rects_load(int count) {
+    init_items(count, 8.0f, 48.0f);
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        set_random_color();
+        scene.objects[i] = spark_graphics_rounded_rectangle("fill", item->x, item->y,
+                                                            item->size, item->size, 4);
+    }
+}
+
+static void rects_update(float dt) {
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        move_item(item, dt);
+        spark_graphics_update_rounded_rectangle(scene.objects[i], item->x, item->y,
+                                                item->size, item->size, 4);
+    }
+}
+
+// Same shapes, applied together at commit
+static void rects_batched_update(float dt) {
+    spark_graphics_begin_update();
+    rects_update(dt);
+    spark_graphics_commit_update();
+}
+
+static void circles_load(int count) {
+    init_items(count, 8.0f, 48.0f);
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        set_random_color();
+        scene.objects[i] = spark_graphics_circle("fill", item->x, item->y, item->size / 2);
+    }
+}
+
+static void circles_update(float dt) {
+    scene.time += dt;
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        move_item(item, dt);
+        float radius = item->size / 2 * (0.75f + 0.25f * sinf(scene.time * 3.0f + item->phase));
+        spark_graphics_update_circle(scene.objects[i], item->x, item->y, radius);
+    }
+}
+
+static void ellipses_load(int count) {
+    init_items(count, 16.0f, 64.0f);
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        set_random_color();
+        scene.objects[i] = spark_graphics_ellipse("fill", item->x, item->y,
+                                                  item->size / 2, item->size / 4);
+    }
+}
+
+static void ellipses_update(float dt) {
+    scene.time += dt;
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        move_item(item, dt);
+        float squash = 0.5f + 0.25f * sinf(scene.time * 2.0f + item->phase);
+        spark_graphics_update_ellipse(scene.objects[i], item->x, item->y,
+                                      item->size / 2, item->size / 2 * squash);
+    }
+}
+
+// Same rectangles as one draw list object, patched in place
+static void draw_rects_load(int count) {
+    init_items(count, 8.0f, 48.0f);
+    scene.draw_list = spark_draw_list_new();
+    spark_draw_set_target(scene.draw_list);
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        set_random_color();
+        spark_draw_rounded_rectangle("fill", item->x, item->y, item->size, item->size, 4);
+    }
+    spark_draw_set_target(NULL);
+}
+
+static void draw_rects_update(float dt) {
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        move_item(item, dt);
+        SparkDrawCommand command = *spark_draw_list_get(scene.draw_list, i);
+        command.x = item->x;
+        command.y = item->y;
+        spark_draw_list_set(scene.draw_list, i, &command);
+    }
+}
+
+static void draw_transformed_load(int count) {
+    init_items(count, 10.0f, 40.0f);
+    scene.draw_list = spark_draw_list_new();
+}
+
+// Rebuilt every frame through the transform stack, half the rects turn
+static void draw_transformed_update(float dt) {
+    scene.time += dt;
+    spark_draw_set_target(scene.draw_list);
+    spark_draw_list_begin(scene.draw_list);
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        move_item(item, dt);
+        spark_graphics_push();
+        spark_graphics_translate(item->x + item->size / 2, item->y + item->size / 2);
+        if (i % 2) spark_graphics_rotate(scene.time + item->phase);
+        spark_draw_rectangle("fill", -item->size / 2, -item->size / 2, item->size, item->size);
+        spark_graphics_pop();
+    }
+    spark_draw_list_end(scene.draw_list);
+    spark_draw_set_target(NULL);
+}
+
+static void point_cloud_load(int count) {
+    init_items(count, 1.0f, 3.0f);
+    scene.point_cloud = spark_graphics_point_cloud_new(0, 0, (float)scene.width, (float)scene.height);
+    spark_graphics_point_cloud_set_point_size(scene.point_cloud, 2.0f);
+}
+
+static void point_cloud_update(float dt) {
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        move_item(item, dt);
+        scene.xy[i * 2] = item->x;
+        scene.xy[i * 2 + 1] = item->y;
+    }
+    spark_graphics_update_point_cloud(scene.point_cloud, scene.xy, scene.count, false);
+}
+
+// Each item erases its old square and fills the new one, so only those
+// rectangles redraw
+static void canvas_load(int count) {
+    init_items(count, 4.0f, 12.0f);
+    scene.canvas = spark_graphics_canvas_new(0, 0, (float)scene.width, (float)scene.height, false);
+}
+
+static void canvas_update(float dt) {
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        int size = (int)item->size;
+        spark_graphics_canvas_fill_rect(scene.canvas, (int)item->x, (int)item->y, size, size, 0);
+        move_item(item, dt);
+        uint32_t color = 0xFF000000u | (scene.seed * (uint32_t)(i + 1)) >> 8;
+        spark_graphics_canvas_fill_rect(scene.canvas, (int)item->x, (int)item->y, size, size, color);
+    }
+}
+
+// Text
+
+static void labels_load(int count) {
+    init_items(count, 60.0f, 60.0f);
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        scene.labels[i] = spark_ui_label_new("0", item->x, item->y, 80, 20);
+    }
+}
+
+static void labels_update(float dt) {
+    char text[32];
+    scene.frame++;
+    for (int i = 0; i < scene.count; i++) {
+        snprintf(text, sizeof(text), "%d:%lu", i, scene.frame);
+        spark_ui_label_set_text(scene.labels[i], text);
+    }
+}
+
+// A telemetry screen: updated every other frame, one value in ten changes
+static void telemetry_update(float dt) {
+    scene.frame++;
+    if (scene.frame % 2) return;
+    unsigned long tick = scene.frame / 2;
+    for (int i = 0; i < scene.count; i++) {
+        spark_ui_label_set_textf(scene.labels[i], "%.1f", (double)((tick + (unsigned long)i) / 10 % 1000) * 0.5);
+    }
+}
+
+// Zooming titles: every text changes size every frame, glyphs are only
+// generated on the first one
+static void sdf_text_load(int count) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/Roboto-Regular.ttf", BENCH_ASSET_DIR);
+    init_items(count, 16.0f, 32.0f);
+    scene.sdf_font = spark_graphics_sdf_font_new(path, 32, 0);
+    if (!scene.sdf_font) {
+        fprintf(stderr, "bench: failed to load %s\n", path);
+        return;
+    }
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        scene.sdf_texts[i] = spark_graphics_sdf_text_new(scene.sdf_font, "Spark2D", item->x, item->y, 16.0f);
+        if (i % 4 == 0) spark_graphics_sdf_text_set_outline(scene.sdf_texts[i], 1.5f, 0.0f, 0.0f, 0.0f, 1.0f);
+    }
+}
+
+static void sdf_text_update(float dt) {
+    scene.time += dt;
+    for (int i = 0; i < scene.count && scene.sdf_font; i++) {
+        Item* item = &scene.items[i];
+        spark_graphics_sdf_text_set_size(scene.sdf_texts[i], 16.0f + 12.0f * sinf(scene.time * 2.0f + item->phase));
+    }
+}
+
+// A HUD of fixed strings at moving positions, drawn immediately every frame
+static const char* const hud_strings[] = { "Score", "Lives", "Level", "Time", "Ammo", "Health" };
+
+static void print_load(int count) {
+    init_items(count, 60.0f, 60.0f);
+    scene.draw_list = spark_draw_list_new();
+}
+
+static void print_update(float dt) {
+    spark_draw_set_target(scene.draw_list);
+    spark_draw_list_begin(scene.draw_list);
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        move_item(item, dt);
+        spark_graphics_print(hud_strings[i % 6], item->x, item->y);
+    }
+    spark_draw_list_end(scene.draw_list);
+    spark_draw_set_target(NULL);
+}
+
+// Images
+
+static void load_images(int count, const char* file) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", BENCH_ASSET_DIR, file);
+
+    init_items(count, 64.0f, 64.0f);
+    for (int i = 0; i < scene.count; i++) {
+        scene.images[i] = spark_graphics_new_image(path);
+        if (!scene.images[i]) {
+            fprintf(stderr, "bench: failed to load %s\n", path);
+            scene.count = i;
+            return;
+        }
+        scene.items[i].size = (float)spark_graphics_image_get_width(scene.images[i]);
+    }
+}
+
+static void images_update(float dt) {
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        move_item(item, dt);
+        lv_obj_set_pos(scene.images[i]->img_obj, (int32_t)item->x, (int32_t)item->y);
+    }
+}
+
+static void png_load(int count) {
+    load_images(count, "cat.png");
+}
+
+static void svg_load(int count) {
+    load_images(count, "home.svg");
+}
+
+static void sprites_load(int count) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/cat.png", BENCH_ASSET_DIR);
+
+    init_items(count, 64.0f, 64.0f);
+    scene.sprite_batch = spark_graphics_sprite_batch_new(path, 0, 0, (float)scene.width, (float)scene.height);
+    if (!scene.sprite_batch) {
+        fprintf(stderr, "bench: failed to load %s\n", path);
+        scene.count = 0;
+        return;
+    }
+    for (int i = 0; i < scene.count; i++) {
+        spark_graphics_sprite_batch_add(scene.sprite_batch, scene.items[i].x, scene.items[i].y);
+    }
+}
+
+static void sprites_update(float dt) {
+    if (!scene.sprite_batch) return;
+
+    float* xy = spark_graphics_sprite_batch_get_arrays(scene.sprite_batch)->xy;
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        move_item(item, dt);
+        xy[i * 2] = item->x;
+        xy[i * 2 + 1] = item->y;
+    }
+    spark_graphics_sprite_batch_changed(scene.sprite_batch);
+}
+
+// Widgets
+
+static void buttons_load(int count) {
+    init_items(count, 100.0f, 100.0f);
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        scene.buttons[i] = spark_ui_button_new_text(item->x, item->y, 100, 36, "Button");
+        lv_obj_set_style_shadow_width(scene.buttons[i]->button, 16, 0);
+        lv_obj_set_style_shadow_offset_y(scene.buttons[i]->button, 4, 0);
+    }
+}
+
+static void buttons_update(float dt) {
+    for (int i = 0; i < scene.count; i++) {
+        Item* item = &scene.items[i];
+        move_item(item, dt);
+        spark_ui_button_set_position(scene.buttons[i], item->x, item->y);
+    }
+}
+
+static void scroll_load(int count) {
+    init_items(count, 0.0f, 0.0f);
+
+    SparkContainerBuilder builder = {
+        .x = 0, .y = 0,
+        .full_width = true,
+        .full_height = true
+    };
+    scene.container = spark_ui_container_create(&builder);
+    spark_ui_set_container(scene.container);
+
+    char text[32];
+    for (int i = 0; i < scene.count; i++) {
+        snprintf(text, sizeof(text), "Row %d", i);
+        scene.labels[i] = spark_ui_label_new(text, 16, 32.0f * i, 200, 28);
+    }
+    spark_ui_set_container(NULL);
+}
+
+static void scroll_update(float dt) {
+    lv_obj_t* container = spark_ui_container_get_native_handle(scene.container);
+
+    // Scroll down, then jump back to the top once the end is reached
+    if (lv_obj_get_scroll_bottom(container) <= 0) {
+        lv_obj_scroll_to_y(container, 0, LV_ANIM_OFF);
+    } else {
+        lv_obj_scroll_by(container, 0, -(int32_t)(240.0f * dt + 1.0f), LV_ANIM_OFF);
+    }
+}
+
+const BenchScene bench_scenes[] = {
+    { "rects", 500, rects_load, rects_update },
+    { "rects_batched", 500, rects_load, rects_batched_update },
+    { "circles", 500, circles_load, circles_update },
+    { "ellipses", 300, ellipses_load, ellipses_update },
+    { "draw_rects", 500, draw_rects_load, draw_rects_update },
+    { "draw_transformed", 500, draw_transformed_load, draw_transformed_update },
+    { "point_cloud", 4000, point_cloud_load, point_cloud_update },
+    { "canvas", 500, canvas_load, canvas_update },
+    { "labels", 300, labels_load, labels_update },
+    { "telemetry", 400, labels_load, telemetry_update },
+    { "sdf_text", 50, sdf_text_load, sdf_text_update },
+    { "print", 300, print_load, print_update },
+    { "images_png", 100, png_load, images_update },
+    { "images_svg", 100, svg_load, images_update },
+    { "sprites", 1000, sprites_load, sprites_update },
+    { "buttons", 100, buttons_load, buttons_update },
+    { "scroll", 500, scroll_load, scroll_update },
+};
+
+const int bench_scene_count = sizeof(bench_scenes) / sizeof(bench_scenes[0]);
+
+const BenchScene* bench_find_scene(const char* name) {
+    for (int i = 0; i < bench_scene_count; i++) {
+        if (strcmp(bench_scenes[i].name, name) == 0) return &bench_scenes[i];
+    }
+    return NULL;
+}
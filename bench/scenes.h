@@ -0,0 +1,17 @@
+// scenes.h
+#ifndef BENCH_SCENES_H
+#define BENCH_SCENES_H
+
+typedef struct {
+    const char* name;
+    int default_count;
+    void (*load)(int count);
+    void (*update)(float dt);
+} BenchScene;
+
+extern const BenchScene bench_scenes[];
+extern const int bench_scene_count;
+
+const BenchScene* bench_find_scene(const char* name);
+
+#endif // BENCH_SCENES_H
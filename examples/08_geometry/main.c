@@ -33,7 +33,7 @@ typedef struct {
     float centerX, centerY;
     float radius;
     float rotation;
-    lv_obj_t* lines[5];
+    lv_obj_t* outline;
 } RotatingStar;
 
 typedef struct {
@@ -134,15 +134,15 @@ void load(void) {
     state.star.centerY = 300;
     state.star.radius = 50;
     spark_graphics_set_color(0.9f, 0.4f, 0.7f);
+    float star_vertices[10];
     for (int i = 0; i < 5; i++) {
-        float angle1 = i * 2 * PI / 5;
-        float angle2 = ((i + 2) % 5) * 2 * PI / 5;
-        float x1 = state.star.centerX + cosf(angle1) * state.star.radius;
-        float y1 = state.star.centerY + sinf(angle1) * state.star.radius;
-        float x2 = state.star.centerX + cosf(angle2) * state.star.radius;
-        float y2 = state.star.centerY + sinf(angle2) * state.star.radius;
-        state.star.lines[i] = spark_graphics_line(x1, y1, x2, y2);
+        // Every second point of the pentagon traces the star in one strip
+        float angle = ((i * 2) % 5) * 2 * PI / 5;
+        star_vertices[i * 2] = state.star.centerX + cosf(angle) * state.star.radius;
+        star_vertices[i * 2 + 1] = state.star.centerY + sinf(angle) * state.star.radius;
     }
+    state.star.outline = spark_graphics_polyline(star_vertices, 5, true);
+    spark_graphics_set_line_width(state.star.outline, 3);
 
     // Initialize and create quad
     state.quad.centerX = 200;
@@ -204,16 +204,14 @@ void update(float dt) {
     }
 
     // Update star
+    float star_vertices[10];
     for (int i = 0; i < 5; i++) {
-        float angle1 = state.rotation * PI / 180.0f + i * 2 * PI / 5;
-        float angle2 = state.rotation * PI / 180.0f + ((i + 2) % 5) * 2 * PI / 5;
-        float x1 = state.star.centerX + cosf(angle1) * state.star.radius;
-        float y1 = state.star.centerY + sinf(angle1) * state.star.radius;
-        float x2 = state.star.centerX + cosf(angle2) * state.star.radius;
-        float y2 = state.star.centerY + sinf(angle2) * state.star.radius;
-        // Update line positions (assuming you have a function for this)
-        spark_graphics_update_line(state.star.lines[i], x1, y1, x2, y2);
+        float angle = state.rotation * PI / 180.0f + ((i * 2) % 5) * 2 * PI / 5;
+        star_vertices[i * 2] = state.star.centerX + cosf(angle) * state.star.radius;
+        star_vertices[i * 2 + 1] = state.star.centerY + sinf(angle) * state.star.radius;
     }
+    spark_graphics_update_polyline(state.star.outline, star_vertices, 5);
+
     float quad_vertices[] = {
         state.quad.centerX - 50 + cosf(state.wave) * 20, state.quad.centerY,
         state.quad.centerX, state.quad.centerY - 50 + sinf(state.wave) * 20,
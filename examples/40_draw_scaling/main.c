@@ -0,0 +1,107 @@
+#include "spark2d.h"
+#include <stdio.h>
+#include <math.h>
+
+// Renders a busy 1080p dashboard with 1..N software draw units and prints
+// the render time for each. Build the library and examples with
+// SPARK_DRAW_UNIT_MAX=8 (or however many cores you have) to see a curve.
+
+#define SCENE_WIDTH 1920
+#define SCENE_HEIGHT 1080
+#define COLUMNS 16
+#define ROWS 9
+#define WARMUP_FRAMES 10
+#define MEASURE_FRAMES 120
+
+static struct {
+    lv_obj_t* tiles[COLUMNS * ROWS];
+    lv_obj_t* gauges[COLUMNS * ROWS];
+    int units;
+    int frame;
+    float baseline_ms;
+    float time;
+} state;
+
+void load(void) {
+    spark_graphics_set_color(0.08f, 0.08f, 0.1f);
+    spark_graphics_rectangle("fill", 0, 0, SCENE_WIDTH, SCENE_HEIGHT);
+
+    float tile_w = (float)SCENE_WIDTH / COLUMNS;
+    float tile_h = (float)SCENE_HEIGHT / ROWS;
+
+    for (int row = 0; row < ROWS; row++) {
+        for (int col = 0; col < COLUMNS; col++) {
+            int i = row * COLUMNS + col;
+            float x = col * tile_w;
+            float y = row * tile_h;
+
+            spark_graphics_set_color(0.2f + 0.04f * col, 0.3f, 0.2f + 0.06f * row);
+            state.tiles[i] = spark_graphics_rounded_rectangle("fill",
+                x + 4, y + 4, tile_w - 8, tile_h - 8, 12);
+            lv_obj_set_style_shadow_width(state.tiles[i], 16, 0);
+            lv_obj_set_style_bg_grad_dir(state.tiles[i], LV_GRAD_DIR_VER, 0);
+
+            spark_graphics_set_color(0.9f, 0.6f, 0.2f);
+            state.gauges[i] = spark_graphics_arc("line",
+                x + tile_w / 2, y + tile_h / 2, tile_h / 3, 0, 270);
+        }
+    }
+
+    state.units = 1;
+    state.frame = 0;
+    spark_set_draw_units(state.units);
+    printf("units  render p50 ms  frame p50 ms  speedup\n");
+}
+
+void update(float dt) {
+    state.time += dt;
+
+    // Keep every tile changing so each frame redraws the whole screen
+    for (int i = 0; i < COLUMNS * ROWS; i++) {
+        int angle = (int)(state.time * 90.0f + i * 7) % 360;
+        lv_arc_set_angles(state.gauges[i], angle, angle + 270);
+    }
+    lv_obj_invalidate(lv_screen_active());
+
+    state.frame++;
+    if (state.frame == WARMUP_FRAMES) {
+        spark_stats_reset();
+    }
+    if (state.frame < WARMUP_FRAMES + MEASURE_FRAMES) return;
+
+    SparkStats stats;
+    if (spark_stats_get(&stats)) {
+        float render = stats.phases[SPARK_STATS_PHASE_RENDER].p50;
+        float frame = stats.phases[SPARK_STATS_PHASE_FRAME].p50;
+        if (state.units == 1) state.baseline_ms = render;
+        printf("%5d  %13.3f  %12.3f  %6.2fx\n", state.units, (double)render, (double)frame,
+               render > 0.0f ? (double)(state.baseline_ms / render) : 0.0);
+    }
+
+    if (state.units >= spark_get_max_draw_units()) {
+        spark_set_max_frames(spark_get_frame_count() + 1);
+        return;
+    }
+
+    state.units++;
+    state.frame = 0;
+    spark_set_draw_units(state.units);
+}
+
+int main(void) {
+    spark_set_backend(SPARK_BACKEND_HEADLESS);
+    if (!spark_init("Spark2D Draw Unit Scaling", SCENE_WIDTH, SCENE_HEIGHT)) {
+        fprintf(stderr, "Failed to initialize Spark2D\n");
+        return 1;
+    }
+
+    // Measure raw throughput, not the frame cap
+    spark_timer_set_target_fps(0);
+
+    spark_set_load(load);
+    spark_set_update(update);
+
+    int result = spark_run();
+    spark_quit();
+    return result;
+}
@@ -5,20 +5,52 @@
 #include "spark_window.h"
 #include "spark_event.h"
 #include "spark_timer.h"
+#include "spark_stats.h"
+#include "spark_render.h"
+#include "spark_debug.h"
 #include "spark_ui.h"
 #include "spark_theme.h"
 #include "spark_filesystem.h"
 #include "spark_mouse.h"
+#include "spark_headless.h"
+#include "spark_replay.h"
+
+typedef enum {
+    SPARK_BACKEND_SDL,       // SDL window with LVGL's SDL display and mouse
+    SPARK_BACKEND_HEADLESS   // Offscreen framebuffer and virtual pointer
+} SparkBackend;
 
 // Core functions
 
+void spark_set_backend(SparkBackend backend);  // Before spark_init, or SPARK_BACKEND=headless
+
 bool spark_init(const char* title, int width, int height);
 void spark_quit(void);
 int spark_run(void);
+void spark_set_max_frames(unsigned long frames);  // 0 runs until quit, or SPARK_MAX_FRAMES
+unsigned long spark_get_frame_count(void);
 
 // Callback setters
 void spark_set_load(void (*load)(void));
 void spark_set_update(void (*update)(float dt));
-void spark_set_draw(void (*draw)(void));
+void spark_set_draw(void (*draw)(void));  // Runs after update each frame, spark_draw_* calls in it redraw only what changed
+
+// Idle mode: block until input, a pushed event or spark_wake() when nothing
+// is animating or invalidated. Update callbacks are continuous by default.
+void spark_set_idle_mode(bool enabled);
+void spark_set_update_continuous(bool continuous);
+void spark_wake(void);  // Safe to call from any thread
+
+// Parallel software rendering: build with SPARK_DRAW_UNIT_MAX > 1 for render
+// threads. Count can be set before spark_init, via SPARK_DRAW_UNITS, or between
+// frames; 0 uses every compiled-in unit.
+void spark_set_draw_units(int count);
+int spark_get_draw_units(void);
+int spark_get_max_draw_units(void);
+
+// Other threads must hold the lock around Spark and LVGL calls. Callbacks
+// from spark_run already run with it held.
+void spark_lock(void);
+void spark_unlock(void);
 
 #endif
@@ -0,0 +1,38 @@
+// spark_debug.h
+#ifndef SPARK_DEBUG_H
+#define SPARK_DEBUG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+#define SPARK_DEBUG_MAX_SOURCES 32
+
+typedef struct {
+    const char* function;   // Spark API call, or "lvgl" for animations, layout and widgets
+    lv_obj_t* object;       // Object the call was made on, NULL if unknown
+    uint32_t areas;
+    uint64_t pixels;
+} SparkInvalidationSource;
+
+typedef struct {
+    unsigned long frame;    // Frame count when the invalidations were rendered
+    uint32_t areas;
+    uint64_t pixels;        // Sum of invalidated areas before LVGL merges them
+    int source_count;
+    SparkInvalidationSource sources[SPARK_DEBUG_MAX_SOURCES];  // Most pixels first
+} SparkInvalidationReport;
+
+// Records which Spark call invalidated each area. Not available in full
+// render mode, where LVGL skips per-area invalidation.
+void spark_debug_set_invalidation_tracking(bool enabled);
+
+// Overlays each frame's invalidated areas with fading colors (SDL backend),
+// enables tracking as well. SPARK_DEBUG_DIRTY=1 turns it on at spark_init.
+void spark_debug_set_dirty_overlay(bool enabled);
+
+// Report for the last rendered frame
+bool spark_debug_get_invalidation_report(SparkInvalidationReport* report);
+void spark_debug_print_invalidation_report(void);
+
+#endif // SPARK_DEBUG_H
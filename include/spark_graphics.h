@@ -8,5 +8,13 @@
 #include "spark_graphics/types.h"
 #include "spark_graphics/core.h"
 #include "spark_graphics/layer.h"
+#include "spark_graphics/draw.h"
+#include "spark_graphics/point_cloud.h"
+#include "spark_graphics/sprite_batch.h"
+#include "spark_graphics/atlas.h"
+#include "spark_graphics/blend.h"
+#include "spark_graphics/canvas.h"
+#include "spark_graphics/font.h"
+#include "spark_graphics/sdf.h"
 
 #endif
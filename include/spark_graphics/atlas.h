@@ -0,0 +1,47 @@
+// spark_graphics/atlas.h
+#ifndef SPARK_GRAPHICS_ATLAS_H
+#define SPARK_GRAPHICS_ATLAS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+// Packs many small images into a few large ARGB8888 pages with a skyline
+// packer. Each added image comes back as an lv_image_dsc_t that views its
+// rectangle of a page, usable anywhere an image source is accepted
+// (lv_image_set_src, spark_ui_button_new_image, ...). Handles stay valid
+// until the atlas is freed.
+typedef struct SparkAtlas SparkAtlas;
+
+typedef struct {
+    int pages;
+    int images;
+    uint64_t used_pixels;
+    uint64_t page_pixels;
+    float occupancy;        // used_pixels / page_pixels
+} SparkAtlasStats;
+
+// Images larger than a page get a page of their own
+SparkAtlas* spark_graphics_atlas_new(int page_width, int page_height);
+void spark_graphics_atlas_free(SparkAtlas* atlas);
+
+// NULL if the image can't be decoded or memory runs out
+const lv_image_dsc_t* spark_graphics_atlas_add(SparkAtlas* atlas, const char* path);
+const lv_image_dsc_t* spark_graphics_atlas_add_pixels(SparkAtlas* atlas, const uint32_t* argb, int w, int h);
+
+// Decodes all files first and packs them tallest first, which fills pages
+// more tightly than adding one at a time. handles[i] is NULL where a file
+// failed; returns how many were added.
+int spark_graphics_atlas_add_files(SparkAtlas* atlas, const char* const* paths, int count,
+                                   const lv_image_dsc_t** handles);
+
+// Pages as image sources, for sprite batches drawing atlas regions
+int spark_graphics_atlas_get_page_count(const SparkAtlas* atlas);
+const lv_image_dsc_t* spark_graphics_atlas_get_page(const SparkAtlas* atlas, int page);
+bool spark_graphics_atlas_get_region(const SparkAtlas* atlas, const lv_image_dsc_t* image,
+                                     int* page, int* x, int* y, int* w, int* h);
+
+void spark_graphics_atlas_get_stats(const SparkAtlas* atlas, SparkAtlasStats* stats);
+float spark_graphics_atlas_get_page_occupancy(const SparkAtlas* atlas, int page);
+
+#endif // SPARK_GRAPHICS_ATLAS_H
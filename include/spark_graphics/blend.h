@@ -0,0 +1,26 @@
+// spark_graphics/blend.h
+#ifndef SPARK_GRAPHICS_BLEND_H
+#define SPARK_GRAPHICS_BLEND_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "core.h"
+
+// Software blending of 0xAARRGGBB pixels with straight alpha, used by the
+// objects that composite their own buffers. The widest instruction set the
+// CPU supports is picked at first use.
+typedef enum {
+    SPARK_SIMD_SCALAR,
+    SPARK_SIMD_SSE2,
+    SPARK_SIMD_AVX2
+} SparkSimdLevel;
+
+// Blends count src pixels over dst. Premultiplied treats dst as opaque.
+void spark_graphics_blend_span(SparkBlendMode mode, uint32_t* dst, const uint32_t* src, int count);
+
+// For comparing kernels, false if the CPU or build lacks the level
+bool spark_graphics_set_simd_level(SparkSimdLevel level);
+SparkSimdLevel spark_graphics_get_simd_level(void);
+const char* spark_graphics_blend_mode_name(SparkBlendMode mode);
+
+#endif // SPARK_GRAPHICS_BLEND_H
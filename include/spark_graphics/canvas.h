@@ -0,0 +1,57 @@
+// spark_graphics/canvas.h
+#ifndef SPARK_GRAPHICS_CANVAS_H
+#define SPARK_GRAPHICS_CANVAS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+// A pixel buffer shown by one object, for procedural content such as
+// heatmaps, waveforms and generated textures. Write pixels directly and
+// report the touched rectangles with spark_graphics_canvas_mark_dirty so
+// only those are redrawn; the fill and blit helpers mark what they touch.
+typedef struct SparkCanvas SparkCanvas;
+
+typedef struct {
+    uint32_t* pixels;       // 0xAARRGGBB, straight alpha
+    int32_t width;
+    int32_t height;
+    int32_t stride;         // Pixels per row, rows may be padded
+    lv_color_format_t format;
+} SparkCanvasBuffer;
+
+// Starts transparent. A double-buffered canvas is written in its
+// back buffer while the front one is shown, so a worker thread can render
+// the next frame; spark_graphics_canvas_swap shows it.
+SparkCanvas* spark_graphics_canvas_new(float x, float y, float w, float h, bool double_buffered);
+void spark_graphics_canvas_free(SparkCanvas* canvas);
+lv_obj_t* spark_graphics_canvas_get_object(SparkCanvas* canvas);
+
+// The buffer writes go to: the back buffer when double buffered. Swapping
+// changes the pointer, fetch it again afterwards.
+bool spark_graphics_canvas_get_buffer(SparkCanvas* canvas, SparkCanvasBuffer* buffer);
+
+// Rectangle in canvas pixels, clipped to the canvas. Single-buffered
+// canvases redraw it on the next frame; double-buffered ones record it for
+// the next swap and don't touch LVGL, so a worker thread may call it.
+void spark_graphics_canvas_mark_dirty(SparkCanvas* canvas, int x, int y, int w, int h);
+
+// Main thread only, after the worker finished writing the back buffer.
+// The new back buffer holds the frame before last, not the one just shown.
+void spark_graphics_canvas_swap(SparkCanvas* canvas);
+
+// Helpers on the write buffer. Fills store the color as is; blits
+// composite with the current blend mode.
+void spark_graphics_canvas_clear(SparkCanvas* canvas, uint32_t color);
+void spark_graphics_canvas_fill_rect(SparkCanvas* canvas, int x, int y, int w, int h, uint32_t color);
+void spark_graphics_canvas_hline(SparkCanvas* canvas, int x, int y, int length, uint32_t color);
+void spark_graphics_canvas_vline(SparkCanvas* canvas, int x, int y, int length, uint32_t color);
+
+// Blits the source canvas's shown buffer, which must be another canvas
+void spark_graphics_canvas_blit(SparkCanvas* canvas, int x, int y, const SparkCanvas* source);
+
+// ARGB8888 images, including atlas handles, are read in place; other
+// formats are decoded on every call.
+void spark_graphics_canvas_blit_image(SparkCanvas* canvas, int x, int y, const lv_image_dsc_t* image);
+
+#endif // SPARK_GRAPHICS_CANVAS_H
@@ -7,27 +7,48 @@
 // Screen management
 void spark_graphics_clear(void);
 
-// Drawing state
+// Drawing state, push saves the transform, origin and blend mode
 void spark_graphics_push(void);
 void spark_graphics_pop(void);
 
-// Transform functions
+// Affine transform: x' = a * x + c * y + tx, y' = b * x + d * y + ty
+typedef struct {
+    float a, b;
+    float c, d;
+    float tx, ty;
+} SparkTransform;
+
+// Transforms compose in call order and apply to spark_draw_* shapes when
+// they are submitted. Angles are radians. Rotated rectangles and ellipses
+// keep their shape, so a non-uniform scale after a rotation loses its skew.
+// spark.draw starts every frame with the identity and an empty stack.
 void spark_graphics_translate(float x, float y);
 void spark_graphics_rotate(float angle);
 void spark_graphics_scale(float sx, float sy);
+void spark_graphics_reset_transform(void);
+const SparkTransform* spark_graphics_get_transform(void);
+
+// Maps count x, y pairs through the current transform, out may equal xy
+void spark_graphics_transform_points(const float* xy, float* out, int count);
 
 // Origin & alignment
 void spark_graphics_set_origin(float x, float y);
 void spark_graphics_reset_origin(void);
 
-// Blending modes
+// Blending modes, saved by push. Draw-list shapes support normal, add,
+// subtract and multiply; sprite batches and canvases support all of them.
 typedef enum {
     SPARK_BLEND_NORMAL,
     SPARK_BLEND_ADD,
     SPARK_BLEND_MULTIPLY,
-    SPARK_BLEND_SCREEN
+    SPARK_BLEND_SCREEN,
+    SPARK_BLEND_SUBTRACT,
+    SPARK_BLEND_OVERLAY,
+    SPARK_BLEND_PREMULTIPLIED,  // Source colors already multiplied by alpha
+    SPARK_BLEND_MODE_COUNT
 } SparkBlendMode;
 
 void spark_graphics_set_blend_mode(SparkBlendMode mode);
+SparkBlendMode spark_graphics_get_blend_mode(void);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,67 @@
+// spark_graphics/draw.h
+#ifndef SPARK_GRAPHICS_DRAW_H
+#define SPARK_GRAPHICS_DRAW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+// Draw lists hold compact shape commands that a single LVGL object renders
+// in its draw event, instead of one lv_obj per shape. Use one as an
+// immediate list rebuilt between spark_draw_list_begin/end, or keep it and
+// patch commands in place with spark_draw_list_set.
+
+typedef enum {
+    SPARK_DRAW_RECTANGLE,   // x, y, w, h, radius for rounded corners
+    SPARK_DRAW_ELLIPSE,     // Bounding box x, y, w, h
+    SPARK_DRAW_POINT,       // x, y
+    SPARK_DRAW_LINE,        // x, y to w, h, radius is the stroke width
+    SPARK_DRAW_TEXT         // x, y, w, h box of a cached text run, from spark_graphics_print
+} SparkDrawShape;
+
+typedef struct {
+    uint8_t shape : 4;      // SparkDrawShape
+    uint8_t blend_mode : 4; // SparkBlendMode at append, captured like the color
+    uint8_t filled;
+    lv_opa_t opa;           // 0 hides the command
+    lv_color_t color;
+    int16_t rotation;       // Rectangles and ellipses, 0.1 degrees about the center
+    float x, y, w, h;
+    union {
+        float radius;
+        uint32_t text;      // SPARK_DRAW_TEXT run, referenced while in a list
+    };
+} SparkDrawCommand;
+
+typedef struct SparkDrawList SparkDrawList;
+
+// Lists render on the current graphics layer, in list order
+SparkDrawList* spark_draw_list_new(void);
+void spark_draw_list_free(SparkDrawList* list);
+void spark_draw_list_clear(SparkDrawList* list);
+int spark_draw_list_get_count(const SparkDrawList* list);
+lv_obj_t* spark_draw_list_get_object(const SparkDrawList* list);
+
+// Immediate use: begin drops the commands, end redraws only if the new
+// commands differ from the previous ones
+void spark_draw_list_begin(SparkDrawList* list);
+void spark_draw_list_end(SparkDrawList* list);
+
+// Retained use: patch a command in place, only its old and new bounds redraw
+const SparkDrawCommand* spark_draw_list_get(const SparkDrawList* list, int index);
+void spark_draw_list_set(SparkDrawList* list, int index, const SparkDrawCommand* command);
+
+// spark_draw_* calls append to the target list with the current color and
+// transform and return the command index, or -1. NULL targets the default
+// list on the active screen.
+void spark_draw_set_target(SparkDrawList* list);
+SparkDrawList* spark_draw_get_target(void);
+
+int spark_draw_rectangle(const char* mode, float x, float y, float w, float h);
+int spark_draw_rounded_rectangle(const char* mode, float x, float y, float w, float h, float radius);
+int spark_draw_circle(const char* mode, float x, float y, float radius);
+int spark_draw_ellipse(const char* mode, float x, float y, float radiusx, float radiusy);
+int spark_draw_point(float x, float y);
+int spark_draw_line(float x1, float y1, float x2, float y2);
+
+#endif // SPARK_GRAPHICS_DRAW_H
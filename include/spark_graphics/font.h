@@ -0,0 +1,42 @@
+// spark_graphics/font.h
+#ifndef SPARK_GRAPHICS_FONT_H
+#define SPARK_GRAPHICS_FONT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+// TrueType fonts rendered with LVGL's tiny_ttf. Each file is mapped once
+// and shared by every size loaded from it. Glyphs are rasterized when first
+// drawn and kept in one LRU cache shared by all fonts, bounded in bytes.
+typedef struct SparkFont SparkFont;
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t bytes;           // Bitmaps currently cached
+    size_t budget;
+    int glyphs;
+} SparkGlyphCacheStats;
+
+// Size is the line height in pixels. NULL if the file can't be read or parsed.
+SparkFont* spark_graphics_new_font(const char* path, int size);
+
+// Clear draw lists and labels using the font first
+void spark_graphics_font_free(SparkFont* font);
+
+// For LVGL styles and widgets
+const lv_font_t* spark_graphics_font_get_lv_font(const SparkFont* font);
+int spark_graphics_font_get_size(const SparkFont* font);
+
+// Used by spark_graphics_print and friends from now on, NULL for the default
+void spark_graphics_set_font(SparkFont* font);
+SparkFont* spark_graphics_get_font(void);
+
+// Shrinking the budget evicts right away, glyphs being drawn excepted
+void spark_graphics_set_glyph_cache_budget(size_t bytes);
+void spark_graphics_get_glyph_cache_stats(SparkGlyphCacheStats* stats);
+void spark_graphics_reset_glyph_cache_stats(void);
+
+#endif // SPARK_GRAPHICS_FONT_H
@@ -4,6 +4,8 @@
 
 #include "lvgl.h"
 
+// Parent of the images, draw lists, canvases, sprite batches, point clouds
+// and SDF texts created from now on
 void spark_graphics_set_layer(lv_obj_t* parent);
 lv_obj_t* spark_graphics_get_current_layer(void);
 
@@ -0,0 +1,32 @@
+// spark_graphics/point_cloud.h
+#ifndef SPARK_GRAPHICS_POINT_CLOUD_H
+#define SPARK_GRAPHICS_POINT_CLOUD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+// Thousands of points plotted by one object into its own ARGB8888 buffer,
+// for scatter plots and live sensor data. Points outside the region are
+// clipped; where points overlap the later one wins.
+typedef struct SparkPointCloud SparkPointCloud;
+
+// Points default to 1 px in the current color
+SparkPointCloud* spark_graphics_point_cloud_new(float x, float y, float w, float h);
+void spark_graphics_point_cloud_free(SparkPointCloud* cloud);
+lv_obj_t* spark_graphics_point_cloud_get_object(SparkPointCloud* cloud);
+
+// xy holds count x, y pairs. With copy the cloud keeps its own array and
+// reuses it across updates; without, it borrows xy, which must stay valid
+// and unchanged until the next update. Either way nothing is reallocated
+// once the count stops growing.
+void spark_graphics_update_point_cloud(SparkPointCloud* cloud, const float* xy, int count, bool copy);
+
+// Optional per-point attributes, borrowed like xy and read at draw time.
+// colors are 0xAARRGGBB, sizes are square edge lengths in pixels. NULL
+// falls back to the cloud's color and point size.
+void spark_graphics_point_cloud_set_colors(SparkPointCloud* cloud, const uint32_t* colors);
+void spark_graphics_point_cloud_set_sizes(SparkPointCloud* cloud, const float* sizes);
+void spark_graphics_point_cloud_set_point_size(SparkPointCloud* cloud, float size);
+
+#endif // SPARK_GRAPHICS_POINT_CLOUD_H
@@ -2,23 +2,17 @@
 #ifndef SPARK_GRAPHICS_PRIMITIVES_H
 #define SPARK_GRAPHICS_PRIMITIVES_H
 
+#include <stdbool.h>
 #include "lvgl.h"
 
-// In primitives_internal.h
-typedef struct {
-    lv_obj_t* container;
-    lv_obj_t** elements;  // Array of line objects or triangle objects
-    int count;            // Number of elements
-    bool is_filled;       // Whether polygon is filled
-} spark_polygon_t;
-
 // Basic shapes
 lv_obj_t* spark_graphics_rectangle(const char* mode, float x, float y, float w, float h);
 lv_obj_t* spark_graphics_circle(const char* mode, float x, float y, float radius);
 lv_obj_t* spark_graphics_arc(const char* mode, float x, float y, float radius, float start_angle, float end_angle);
 lv_obj_t* spark_graphics_line(float x1, float y1, float x2, float y2);
 lv_obj_t* spark_graphics_point(float x, float y);
-lv_obj_t* spark_graphics_polygon(const char* mode, const float* vertices, int count);
+lv_obj_t* spark_graphics_polygon(const char* mode, const float* vertices, int count);  // Convex or concave, non-zero fill
+lv_obj_t* spark_graphics_polyline(const float* vertices, int count, bool closed);      // Joined strip of count x, y pairs
 lv_obj_t* spark_graphics_triangle(const char* mode, float x1, float y1, float x2, float y2, float x3, float y3);
 lv_obj_t* spark_graphics_quad(const char* mode, float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4);
 lv_obj_t* spark_graphics_ellipse(const char* mode, float x, float y, float radiusx, float radiusy);
@@ -32,10 +26,23 @@ void spark_graphics_update_arc(lv_obj_t* arc, float x, float y, float radius, fl
 void spark_graphics_update_line(lv_obj_t* line, float x1, float y1, float x2, float y2);
 void spark_graphics_update_point(lv_obj_t* point, float x, float y);
 void spark_graphics_update_polygon(lv_obj_t* polygon, const float* vertices, int count);
+void spark_graphics_update_polyline(lv_obj_t* polyline, const float* vertices, int count);
 void spark_graphics_update_triangle(lv_obj_t* triangle, float x1, float y1, float x2, float y2, float x3, float y3);
 void spark_graphics_update_quad(lv_obj_t* quad, float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4);
 void spark_graphics_update_ellipse(lv_obj_t* ellipse, float x, float y, float radiusx, float radiusy);
 void spark_graphics_update_rounded_rectangle(lv_obj_t* rect, float x, float y, float w, float h, float radius);
 
+// Shape updates between begin and commit are buffered, and commit applies
+// each object's final position, size and style with one layout pass and a
+// single invalidation of its old and new bounds. Lines, polylines and
+// polygons, and shapes inside layout containers, still update at once.
+// Shapes deleted before commit are dropped from it. Transactions nest; one
+// left open is committed when the update callback returns.
+void spark_graphics_begin_update(void);
+void spark_graphics_commit_update(void);
+
+// Stroke width of lines, polylines and polygon outlines, 1 by default
+void spark_graphics_set_line_width(lv_obj_t* line, float width);
+
 
 #endif // SPARK_GRAPHICS_PRIMITIVES_H
\ No newline at end of file
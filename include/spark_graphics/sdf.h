@@ -0,0 +1,49 @@
+// spark_graphics/sdf.h
+#ifndef SPARK_GRAPHICS_SDF_H
+#define SPARK_GRAPHICS_SDF_H
+
+#include <stdbool.h>
+#include "lvgl.h"
+
+// Signed distance field text. Glyphs of a TrueType font are rasterized
+// once at a base size, turned into distance fields and packed into an A8
+// atlas; text is then drawn at any size by thresholding the fields, so
+// zooming or animating the size never rasterizes glyphs again. Outlines
+// and glows come from the same fields.
+typedef struct SparkSdfFont SparkSdfFont;
+typedef struct SparkSdfText SparkSdfText;
+
+// Spread is how far the field reaches past a glyph's edge in base pixels,
+// 0 for base_size / 8. It bounds outline and glow widths: at size S they
+// reach at most spread * S / base_size pixels.
+SparkSdfFont* spark_graphics_sdf_font_new(const char* path, int base_size, int spread);
+
+// Free the texts using the font first
+void spark_graphics_sdf_font_free(SparkSdfFont* font);
+
+// Glyphs are generated on first use; preloading moves that cost to load
+// time. Returns how many glyphs were generated.
+int spark_graphics_sdf_font_preload(SparkSdfFont* font, const char* text);
+
+// The atlas as an A8 image, for inspection
+const lv_image_dsc_t* spark_graphics_sdf_font_get_atlas(const SparkSdfFont* font);
+
+// Top-left of the first line at x, y on the current layer, size being the
+// line height in pixels. White, no outline or glow.
+SparkSdfText* spark_graphics_sdf_text_new(SparkSdfFont* font, const char* text, float x, float y, float size);
+void spark_graphics_sdf_text_free(SparkSdfText* text);
+lv_obj_t* spark_graphics_sdf_text_get_object(SparkSdfText* text);
+
+void spark_graphics_sdf_text_set_text(SparkSdfText* text, const char* string);
+void spark_graphics_sdf_text_set_position(SparkSdfText* text, float x, float y);
+void spark_graphics_sdf_text_set_size(SparkSdfText* text, float size);
+void spark_graphics_sdf_text_set_color(SparkSdfText* text, float r, float g, float b, float a);
+
+// Widths in output pixels, 0 turns them off, clamped to what the field reaches
+void spark_graphics_sdf_text_set_outline(SparkSdfText* text, float width, float r, float g, float b, float a);
+void spark_graphics_sdf_text_set_glow(SparkSdfText* text, float radius, float r, float g, float b, float a);
+
+// Of the text at its current size, outline and glow excluded
+void spark_graphics_sdf_text_get_size(const SparkSdfText* text, float* width, float* height);
+
+#endif // SPARK_GRAPHICS_SDF_H
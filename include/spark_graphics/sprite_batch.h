@@ -0,0 +1,47 @@
+// spark_graphics/sprite_batch.h
+#ifndef SPARK_GRAPHICS_SPRITE_BATCH_H
+#define SPARK_GRAPHICS_SPRITE_BATCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+#include "core.h"
+
+// Many copies of one image, or of regions of one atlas, composited by a
+// single object into its own ARGB8888 buffer. A sprite is a few arrays
+// entries instead of an lv_image object.
+typedef struct SparkSpriteBatch SparkSpriteBatch;
+
+// Per-sprite attributes, one array per attribute. Write them directly and
+// call spark_graphics_sprite_batch_changed, or use the setters.
+typedef struct {
+    float* xy;              // Top-left x, y pairs
+    uint16_t* regions;      // Source x, y, w, h in the image, clipped to it
+    float* rotations;       // Radians about the sprite center
+    float* scales;          // Uniform, about the sprite center
+    uint32_t* colors;       // 0xAARRGGBB tint and alpha, 0xFFFFFFFF draws as is
+    uint8_t* blend_modes;   // SparkBlendMode, the current mode when added
+    int count;
+} SparkSpriteArrays;
+
+// Sprites outside the x, y, w, h region are clipped
+SparkSpriteBatch* spark_graphics_sprite_batch_new(const char* path, float x, float y, float w, float h);
+SparkSpriteBatch* spark_graphics_sprite_batch_new_from_image(const lv_image_dsc_t* image,
+                                                             float x, float y, float w, float h);
+void spark_graphics_sprite_batch_free(SparkSpriteBatch* batch);
+lv_obj_t* spark_graphics_sprite_batch_get_object(SparkSpriteBatch* batch);
+
+// Adds a sprite showing the whole image, returns its index or -1
+int spark_graphics_sprite_batch_add(SparkSpriteBatch* batch, float x, float y);
+void spark_graphics_sprite_batch_clear(SparkSpriteBatch* batch);
+
+void spark_graphics_sprite_batch_set_position(SparkSpriteBatch* batch, int index, float x, float y);
+void spark_graphics_sprite_batch_set_region(SparkSpriteBatch* batch, int index, int x, int y, int w, int h);
+void spark_graphics_sprite_batch_set_transform(SparkSpriteBatch* batch, int index, float rotation, float scale);
+void spark_graphics_sprite_batch_set_color(SparkSpriteBatch* batch, int index, float r, float g, float b, float a);
+void spark_graphics_sprite_batch_set_blend_mode(SparkSpriteBatch* batch, int index, SparkBlendMode mode);
+
+SparkSpriteArrays* spark_graphics_sprite_batch_get_arrays(SparkSpriteBatch* batch);
+void spark_graphics_sprite_batch_changed(SparkSpriteBatch* batch);
+
+#endif // SPARK_GRAPHICS_SPRITE_BATCH_H
@@ -15,7 +15,15 @@ void spark_graphics_text_get_scaled_size(SparkText* text, float* width, float* h
 float spark_graphics_text_get_width(SparkText* text);
 float spark_graphics_text_get_height(SparkText* text);
 
-// Text drawing
+// Size of text as LVGL lays it out, memoized process-wide by font, letter
+// and line spacing, wrap width and string. A wrap width of 0 doesn't wrap;
+// a NULL font is the current one. Hit rates are in spark_stats_get.
+void spark_graphics_measure_text(const char* text, const lv_font_t* font, int32_t letter_space,
+                                 int32_t line_space, int32_t wrap_width, int32_t* width, int32_t* height);
+
+// Text drawing, appended to the draw target like the spark_draw_* calls
+// (the frame list inside the draw callback). Each distinct string is
+// measured and copied once and reused while it keeps being drawn.
 void spark_graphics_text_draw(SparkText* text, float x, float y);
 void spark_graphics_print(const char* text, float x, float y);
 void spark_graphics_printf(const char* text, float x, float y, float wrap_width, SparkTextAlign align);
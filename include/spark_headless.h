@@ -0,0 +1,23 @@
+// spark_headless.h
+#ifndef SPARK_HEADLESS_H
+#define SPARK_HEADLESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+// Called for every flushed area; pixels points at the area's top-left ARGB8888 pixel
+typedef void (*SparkHeadlessFlushCallback)(const lv_area_t* area, const uint8_t* pixels,
+                                           uint32_t stride, void* user_data);
+
+// Frame output
+void spark_headless_set_flush_callback(SparkHeadlessFlushCallback callback, void* user_data);
+const uint8_t* spark_headless_get_framebuffer(int* width, int* height, uint32_t* stride);
+
+// Virtual pointer, consumed in order by the LVGL pointer indev
+void spark_headless_pointer_move(float x, float y);
+void spark_headless_pointer_press(void);
+void spark_headless_pointer_release(void);
+void spark_headless_pointer_click(float x, float y);
+
+#endif // SPARK_HEADLESS_H
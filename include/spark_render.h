@@ -0,0 +1,41 @@
+// spark_render.h
+#ifndef SPARK_RENDER_H
+#define SPARK_RENDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    SPARK_RENDER_DIRECT,   // One screen-sized buffer, only dirty areas are redrawn
+    SPARK_RENDER_PARTIAL,  // Dirty areas are drawn in bands of a few lines
+    SPARK_RENDER_FULL      // The whole screen is redrawn on every change
+} SparkRenderMode;
+
+typedef struct {
+    unsigned long frames;      // Refreshes that rendered something
+    size_t buffer_bytes;       // Draw buffer memory
+
+    // Last rendered frame
+    uint32_t areas;            // Dirty areas invalidated
+    uint32_t areas_merged;     // Of those, joined into a neighbour before rendering
+    uint64_t rendered_pixels;
+    uint64_t flush_bytes;
+    uint32_t flushes;
+
+    // Averages per rendered frame
+    float avg_areas_merged;
+    float avg_rendered_pixels;
+    float avg_flush_bytes;
+} SparkRenderStats;
+
+// Before spark_init, or SPARK_RENDER_MODE=direct|partial|full and
+// SPARK_RENDER_BAND=lines. band_lines only applies to partial mode,
+// 0 picks a tenth of the screen height.
+void spark_set_render_mode(SparkRenderMode mode, int band_lines);
+SparkRenderMode spark_get_render_mode(void);
+
+void spark_render_get_stats(SparkRenderStats* stats);
+void spark_render_reset_stats(void);
+
+#endif // SPARK_RENDER_H
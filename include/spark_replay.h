@@ -0,0 +1,27 @@
+// spark_replay.h
+#ifndef SPARK_REPLAY_H
+#define SPARK_REPLAY_H
+
+#include <stdbool.h>
+
+// Records pointer, key, wheel and resize input plus every spark_event_push
+// to a compact binary file, timestamped from the first frame after the
+// recording starts. Call after spark_init. SPARK_RECORD=path starts one at
+// spark_init; the file is finalized by spark_replay_stop_recording or spark_quit.
+bool spark_replay_start_recording(const char* path);
+void spark_replay_stop_recording(void);
+bool spark_replay_is_recording(void);
+
+// Plays a recording back through the LVGL pointer indev, keyboard state and
+// event queue on a virtual clock that advances step seconds per frame
+// (0 uses 1/60), so runs are identical however fast frames render. Live
+// input and live spark_event_push calls are ignored while it plays, the
+// recorded pushes stand in for them. spark_timer_get_time stays wall clock
+// time so stats and benchmarks measure real frame cost.
+// SPARK_REPLAY=path (and SPARK_REPLAY_STEP) start one at spark_init that
+// quits the app when it ends.
+bool spark_replay_start(const char* path, float step, bool quit_at_end);
+void spark_replay_stop(void);
+bool spark_replay_is_playing(void);
+
+#endif // SPARK_REPLAY_H
@@ -0,0 +1,55 @@
+// spark_stats.h
+#ifndef SPARK_STATS_H
+#define SPARK_STATS_H
+
+#include <stdbool.h>
+
+// Number of frames kept for percentile queries
+#define SPARK_STATS_RING_SIZE 1024
+
+typedef enum {
+    SPARK_STATS_PHASE_EVENTS,   // SDL event polling
+    SPARK_STATS_PHASE_UPDATE,   // User update callback(s)
+    SPARK_STATS_PHASE_LAYOUT,   // lv_timer_handler: refresh start until rendering
+    SPARK_STATS_PHASE_RENDER,   // lv_timer_handler: rendering, minus flushing
+    SPARK_STATS_PHASE_FLUSH,    // lv_timer_handler: display flush callbacks
+    SPARK_STATS_PHASE_TIMERS,   // lv_timer_handler: everything else (indev, anims, user timers)
+    SPARK_STATS_PHASE_SLEEP,    // Frame pacing / idle wait
+    SPARK_STATS_PHASE_FRAME,    // Whole frame
+    SPARK_STATS_PHASE_COUNT
+} SparkStatsPhase;
+
+typedef enum {
+    SPARK_STATS_FORMAT_CSV,
+    SPARK_STATS_FORMAT_JSON     // One JSON object per line
+} SparkStatsFormat;
+
+typedef struct {
+    float p50;
+    float p95;
+    float p99;
+    float max;
+    float mean;
+} SparkStatsPhaseSummary;  // Milliseconds
+
+typedef struct {
+    unsigned long frames;   // Frames recorded since start or reset
+    int samples;            // Frames the summaries are computed over
+    SparkStatsPhaseSummary phases[SPARK_STATS_PHASE_COUNT];
+
+    // Text measurement cache since start or reset
+    unsigned long text_measure_hits;
+    unsigned long text_measure_misses;
+    float text_measure_hit_rate;    // 0 to 1, 0 before any lookup
+} SparkStats;
+
+// Queries
+bool spark_stats_get(SparkStats* stats);
+const char* spark_stats_phase_name(SparkStatsPhase phase);
+void spark_stats_reset(void);
+
+// Background exporter, appends a summary to path every interval seconds
+bool spark_stats_start_exporter(const char* path, SparkStatsFormat format, float interval);
+void spark_stats_stop_exporter(void);
+
+#endif // SPARK_STATS_H
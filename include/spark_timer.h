@@ -0,0 +1,28 @@
+// spark_timer.h
+#ifndef SPARK_TIMER_H
+#define SPARK_TIMER_H
+
+#include <stdbool.h>
+
+// Clock queries (monotonic, seconds since spark_init)
+double spark_timer_get_time(void);
+float spark_timer_get_delta(void);
+void spark_timer_sleep(double seconds);
+
+// Frame pacing
+void spark_timer_set_target_fps(float fps);   // 0 disables the frame cap
+float spark_timer_get_target_fps(void);
+void spark_timer_set_fixed_step(float step);  // 0 passes the measured dt to update
+float spark_timer_get_fixed_step(void);
+void spark_timer_set_max_steps(int max_steps); // Catch-up clamp for the fixed step
+float spark_timer_get_alpha(void);            // Leftover accumulator / fixed step
+
+// Pacing statistics (over the last SPARK_TIMER_WINDOW frames)
+#define SPARK_TIMER_WINDOW 128
+
+float spark_timer_get_fps(void);
+float spark_timer_get_average_delta(void);
+float spark_timer_get_delta_variance(void);
+unsigned long spark_timer_get_skipped_steps(void);
+
+#endif // SPARK_TIMER_H
@@ -3,6 +3,7 @@
 #define SPARK_UI_BUTTON_H
 
 #include "../../../deps/lvgl/lvgl.h"
+#include "label.h"
 
 typedef void (*SparkButtonCallback)(void* user_data);
 
@@ -17,9 +18,11 @@ typedef struct {
     float height;
     SparkButtonCallback callback;
     void* user_data;
+    SparkLabelText text;
 } SparkButton;
 
-// Creation and destruction
+// Creation and destruction. A text button with width or height 0 is sized
+// to fit its text plus padding.
 SparkButton* spark_ui_button_new_text(float x, float y, float width, float height, const char* text);
 SparkButton* spark_ui_button_new_image(float x, float y, float width, float height, const void* img_src);
 SparkButton* spark_ui_button_new_text_and_image(float x, float y, float width, float height, 
@@ -30,11 +33,14 @@ void spark_ui_button_free(SparkButton* button);
 void spark_ui_button_set_callback(SparkButton* button, SparkButtonCallback callback, void* user_data);
 void spark_ui_button_set_position(SparkButton* button, float x, float y);
 void spark_ui_button_set_size(SparkButton* button, float width, float height);
-void spark_ui_button_set_text(SparkButton* button, const char* text);
+void spark_ui_button_set_text(SparkButton* button, const char* text);  // Like spark_ui_label_set_text
+void spark_ui_button_set_textf(SparkButton* button, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
 
 // Button state queries
 void spark_ui_button_get_position(SparkButton* button, float* x, float* y);
 void spark_ui_button_get_size(SparkButton* button, float* width, float* height);
 const char* spark_ui_button_get_text(const SparkButton* button);
+void spark_ui_button_get_text_size(const SparkButton* button, float* width, float* height);
 
 #endif
\ No newline at end of file
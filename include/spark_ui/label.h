@@ -2,6 +2,17 @@
 #define SPARK_UI_LABEL_H
 
 #include "../../../deps/lvgl/lvgl.h"
+#include "../spark_graphics/font.h"
+
+// Text set through Spark is formatted into next and swapped with shown,
+// which LVGL draws as static text, so updates don't allocate once the
+// buffers are large enough
+typedef struct {
+    char* shown;
+    char* next;
+    size_t shown_capacity;
+    size_t next_capacity;
+} SparkLabelText;
 
 typedef struct {
     lv_obj_t* label;
@@ -10,13 +21,19 @@ typedef struct {
     float y;
     float width;
     float height;
+    SparkLabelText text;
 } SparkLabel;
 
 SparkLabel* spark_ui_label_new(const char* text, float x, float y, float width, float height);
+// Unchanged text is skipped; changed text redraws only the old and new text
 void spark_ui_label_set_text(SparkLabel* label, const char* text);
+void spark_ui_label_set_textf(SparkLabel* label, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
 void spark_ui_label_set_position(SparkLabel* label, float x, float y);
 void spark_ui_label_set_size(SparkLabel* label, float width, float height);
+void spark_ui_label_set_font(SparkLabel* label, SparkFont* font);  // NULL restores the default
 const char* spark_ui_label_get_text(const SparkLabel* label);
+void spark_ui_label_get_text_size(const SparkLabel* label, float* width, float* height);  // Unwrapped, for sizing around it
 void spark_ui_label_free(SparkLabel* label);
 
 #endif
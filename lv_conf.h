@@ -106,7 +106,15 @@
  * - LV_OS_WINDOWS
  * - LV_OS_MQX
  * - LV_OS_CUSTOM */
-#define LV_USE_OS   LV_OS_NONE
+/* Spark2D: builds with SPARK_DRAW_UNIT_MAX > 1 use pthreads for parallel rendering */
+#ifndef SPARK_DRAW_UNIT_MAX
+    #define SPARK_DRAW_UNIT_MAX 1
+#endif
+#if SPARK_DRAW_UNIT_MAX > 1 && !defined(__EMSCRIPTEN__)
+    #define LV_USE_OS   LV_OS_PTHREAD
+#else
+    #define LV_USE_OS   LV_OS_NONE
+#endif
 
 #if LV_USE_OS == LV_OS_CUSTOM
     #define LV_OS_CUSTOM_INCLUDE <stdint.h>
@@ -170,7 +178,11 @@
     /** Set number of draw units.
      *  - > 1 requires operating system to be enabled in `LV_USE_OS`.
      *  - > 1 means multiple threads will render the screen in parallel. */
-    #define LV_DRAW_SW_DRAW_UNIT_CNT    1
+    #if LV_USE_OS == LV_OS_PTHREAD
+        #define LV_DRAW_SW_DRAW_UNIT_CNT    SPARK_DRAW_UNIT_MAX
+    #else
+        #define LV_DRAW_SW_DRAW_UNIT_CNT    1
+    #endif
 
     /** Use Arm-2D to accelerate software (sw) rendering. */
     #define LV_USE_DRAW_ARM2D_SYNC      0
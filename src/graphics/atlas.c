@@ -0,0 +1,387 @@
+// atlas.c
+#include "spark_graphics/atlas.h"
+#include "../internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ENTRY_BLOCK 64
+
+// Skyline segment: the packed area's top edge is at y from x to x + width
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t width;
+} SkylineNode;
+
+typedef struct {
+    lv_image_dsc_t image;
+    uint32_t* pixels;
+    int32_t width;
+    int32_t height;
+    SkylineNode* skyline;
+    int node_count;
+    int node_capacity;
+    uint64_t used;
+} AtlasPage;
+
+typedef struct {
+    lv_image_dsc_t image;   // Handles point here
+    int page;
+    int32_t x;
+    int32_t y;
+} AtlasEntry;
+
+// Entries never move, so handles stay valid as the atlas grows
+typedef struct EntryBlock {
+    struct EntryBlock* next;
+    int count;
+    AtlasEntry entries[ENTRY_BLOCK];
+} EntryBlock;
+
+struct SparkAtlas {
+    int32_t page_width;
+    int32_t page_height;
+    AtlasPage** pages;
+    int page_count;
+    int page_capacity;
+    EntryBlock* blocks;     // Newest first
+    int image_count;
+};
+
+SparkAtlas* spark_graphics_atlas_new(int page_width, int page_height) {
+    // Sub-images address rows through a 16-bit stride
+    if (page_width < 1 || page_height < 1 || page_width * 4 > UINT16_MAX || page_height > UINT16_MAX) {
+        fprintf(stderr, "Invalid atlas page size %dx%d\n", page_width, page_height);
+        return NULL;
+    }
+
+    SparkAtlas* atlas = calloc(1, sizeof(SparkAtlas));
+    if (!atlas) return NULL;
+    atlas->page_width = page_width;
+    atlas->page_height = page_height;
+    return atlas;
+}
+
+void spark_graphics_atlas_free(SparkAtlas* atlas) {
+    if (!atlas) return;
+
+    // LVGL caches by source pointer, a later allocation could reuse these
+    for (EntryBlock* block = atlas->blocks; block;) {
+        EntryBlock* next = block->next;
+        for (int i = 0; i < block->count; i++) {
+            lv_image_cache_drop(&block->entries[i].image);
+            lv_image_header_cache_drop(&block->entries[i].image);
+        }
+        free(block);
+        block = next;
+    }
+    for (int i = 0; i < atlas->page_count; i++) {
+        lv_image_cache_drop(&atlas->pages[i]->image);
+        lv_image_header_cache_drop(&atlas->pages[i]->image);
+        free(atlas->pages[i]->pixels);
+        free(atlas->pages[i]->skyline);
+        free(atlas->pages[i]);
+    }
+    free(atlas->pages);
+    free(atlas);
+}
+
+static AtlasPage* add_page(SparkAtlas* atlas, int32_t width, int32_t height) {
+    if (atlas->page_count == atlas->page_capacity) {
+        int capacity = atlas->page_capacity > 0 ? atlas->page_capacity * 2 : 4;
+        AtlasPage** grown = realloc(atlas->pages, sizeof(AtlasPage*) * capacity);
+        if (!grown) return NULL;
+        atlas->pages = grown;
+        atlas->page_capacity = capacity;
+    }
+
+    AtlasPage* page = calloc(1, sizeof(AtlasPage));
+    if (!page) return NULL;
+    // A row of slack so every sub-image can claim a full stride per row,
+    // which LVGL requires of an image's data size
+    page->pixels = calloc((size_t)width * (height + 1), 4);
+    page->skyline = malloc(sizeof(SkylineNode) * 16);
+    if (!page->pixels || !page->skyline) {
+        free(page->pixels);
+        free(page->skyline);
+        free(page);
+        return NULL;
+    }
+
+    page->width = width;
+    page->height = height;
+    page->skyline[0] = (SkylineNode){ 0, 0, width };
+    page->node_count = 1;
+    page->node_capacity = 16;
+
+    page->image.header.magic = LV_IMAGE_HEADER_MAGIC;
+    page->image.header.cf = LV_COLOR_FORMAT_ARGB8888;
+    page->image.header.w = width;
+    page->image.header.h = height;
+    page->image.header.stride = width * 4;
+    page->image.data = (const uint8_t*)page->pixels;
+    page->image.data_size = (uint32_t)width * height * 4;
+
+    atlas->pages[atlas->page_count++] = page;
+    return page;
+}
+
+// Lowest y at which a w x h rectangle fits with its left edge on node index
+static int32_t skyline_fit(const AtlasPage* page, int index, int32_t w, int32_t h) {
+    if (page->skyline[index].x + w > page->width) return -1;
+
+    int32_t y = 0;
+    int32_t remaining = w;
+    for (int i = index; remaining > 0; i++) {
+        if (page->skyline[i].y > y) y = page->skyline[i].y;
+        if (y + h > page->height) return -1;
+        remaining -= page->skyline[i].width;
+    }
+    return y;
+}
+
+static void remove_node(AtlasPage* page, int index) {
+    memmove(&page->skyline[index], &page->skyline[index + 1],
+            sizeof(SkylineNode) * (page->node_count - index - 1));
+    page->node_count--;
+}
+
+// Bottom-left skyline placement: the spot with the lowest top edge, ties
+// going to the narrowest segment so wide gaps stay open
+static bool skyline_insert(AtlasPage* page, int32_t w, int32_t h, int32_t* out_x, int32_t* out_y) {
+    int best = -1;
+    int32_t best_top = INT32_MAX;
+    int32_t best_width = INT32_MAX;
+    int32_t best_y = 0;
+
+    for (int i = 0; i < page->node_count; i++) {
+        int32_t y = skyline_fit(page, i, w, h);
+        if (y < 0) continue;
+        if (y + h < best_top || (y + h == best_top && page->skyline[i].width < best_width)) {
+            best = i;
+            best_top = y + h;
+            best_width = page->skyline[i].width;
+            best_y = y;
+        }
+    }
+    if (best < 0) return false;
+
+    if (page->node_count == page->node_capacity) {
+        SkylineNode* grown = realloc(page->skyline, sizeof(SkylineNode) * page->node_capacity * 2);
+        if (!grown) return false;
+        page->skyline = grown;
+        page->node_capacity *= 2;
+    }
+
+    *out_x = page->skyline[best].x;
+    *out_y = best_y;
+    memmove(&page->skyline[best + 1], &page->skyline[best],
+            sizeof(SkylineNode) * (page->node_count - best));
+    page->skyline[best] = (SkylineNode){ *out_x, best_top, w };
+    page->node_count++;
+
+    // Trim the segments the new one now covers
+    for (int i = best + 1; i < page->node_count;) {
+        int32_t covered_end = page->skyline[i - 1].x + page->skyline[i - 1].width;
+        SkylineNode* node = &page->skyline[i];
+        if (node->x >= covered_end) break;
+
+        int32_t shrink = covered_end - node->x;
+        node->x += shrink;
+        node->width -= shrink;
+        if (node->width > 0) break;
+        remove_node(page, i);
+    }
+
+    for (int i = 0; i + 1 < page->node_count;) {
+        if (page->skyline[i].y == page->skyline[i + 1].y) {
+            page->skyline[i].width += page->skyline[i + 1].width;
+            remove_node(page, i + 1);
+        } else {
+            i++;
+        }
+    }
+
+    page->used += (uint64_t)w * h;
+    return true;
+}
+
+static AtlasEntry* new_entry(SparkAtlas* atlas) {
+    if (!atlas->blocks || atlas->blocks->count == ENTRY_BLOCK) {
+        EntryBlock* block = calloc(1, sizeof(EntryBlock));
+        if (!block) return NULL;
+        block->next = atlas->blocks;
+        atlas->blocks = block;
+    }
+    return &atlas->blocks->entries[atlas->blocks->count++];
+}
+
+const lv_image_dsc_t* spark_graphics_atlas_add_pixels(SparkAtlas* atlas, const uint32_t* argb, int w, int h) {
+    if (!atlas || !argb || w < 1 || h < 1) return NULL;
+
+    int page_index = -1;
+    int32_t x = 0, y = 0;
+    for (int i = 0; i < atlas->page_count; i++) {
+        if (skyline_insert(atlas->pages[i], w, h, &x, &y)) {
+            page_index = i;
+            break;
+        }
+    }
+
+    if (page_index < 0) {
+        int32_t width = w > atlas->page_width ? w : atlas->page_width;
+        int32_t height = h > atlas->page_height ? h : atlas->page_height;
+        if (width * 4 > UINT16_MAX || height > UINT16_MAX) {
+            fprintf(stderr, "Image of %dx%d is too large for an atlas\n", w, h);
+            return NULL;
+        }
+        AtlasPage* page = add_page(atlas, width, height);
+        if (!page || !skyline_insert(page, w, h, &x, &y)) return NULL;
+        page_index = atlas->page_count - 1;
+    }
+
+    AtlasEntry* entry = new_entry(atlas);
+    if (!entry) return NULL;
+
+    AtlasPage* page = atlas->pages[page_index];
+    for (int row = 0; row < h; row++) {
+        memcpy(page->pixels + (size_t)(y + row) * page->width + x, argb + (size_t)row * w, (size_t)w * 4);
+    }
+    // Anything that decoded the whole page holds a stale copy
+    lv_image_cache_drop(&page->image);
+
+    entry->page = page_index;
+    entry->x = x;
+    entry->y = y;
+    entry->image.header.magic = LV_IMAGE_HEADER_MAGIC;
+    entry->image.header.cf = LV_COLOR_FORMAT_ARGB8888;
+    entry->image.header.w = w;
+    entry->image.header.h = h;
+    entry->image.header.stride = page->width * 4;
+    entry->image.data = (const uint8_t*)(page->pixels + (size_t)y * page->width + x);
+    entry->image.data_size = entry->image.header.stride * h;
+    atlas->image_count++;
+    return &entry->image;
+}
+
+const lv_image_dsc_t* spark_graphics_atlas_add(SparkAtlas* atlas, const char* path) {
+    if (!atlas || !path) return NULL;
+
+    char full_path[1024];
+    snprintf(full_path, sizeof(full_path), "A:%s", path);
+
+    int32_t w, h;
+    uint32_t* pixels = spark_image_decode_argb8888(full_path, &w, &h);
+    if (!pixels) {
+        fprintf(stderr, "Failed to load atlas image %s\n", path);
+        return NULL;
+    }
+
+    const lv_image_dsc_t* image = spark_graphics_atlas_add_pixels(atlas, pixels, w, h);
+    free(pixels);
+    return image;
+}
+
+typedef struct {
+    uint32_t* pixels;
+    int32_t w;
+    int32_t h;
+    int index;
+} PendingImage;
+
+static int compare_height(const void* a, const void* b) {
+    const PendingImage* pa = a;
+    const PendingImage* pb = b;
+    if (pa->h != pb->h) return pb->h - pa->h;
+    return pb->w - pa->w;
+}
+
+int spark_graphics_atlas_add_files(SparkAtlas* atlas, const char* const* paths, int count,
+                                   const lv_image_dsc_t** handles) {
+    if (!atlas || !paths || !handles || count <= 0) return 0;
+
+    PendingImage* pending = calloc(count, sizeof(PendingImage));
+    if (!pending) return 0;
+
+    int decoded = 0;
+    for (int i = 0; i < count; i++) {
+        handles[i] = NULL;
+        char full_path[1024];
+        snprintf(full_path, sizeof(full_path), "A:%s", paths[i]);
+        PendingImage* image = &pending[decoded];
+        image->pixels = spark_image_decode_argb8888(full_path, &image->w, &image->h);
+        if (!image->pixels) {
+            fprintf(stderr, "Failed to load atlas image %s\n", paths[i]);
+            continue;
+        }
+        image->index = i;
+        decoded++;
+    }
+
+    qsort(pending, decoded, sizeof(PendingImage), compare_height);
+
+    int added = 0;
+    for (int i = 0; i < decoded; i++) {
+        const lv_image_dsc_t* image = spark_graphics_atlas_add_pixels(atlas, pending[i].pixels,
+                                                                      pending[i].w, pending[i].h);
+        handles[pending[i].index] = image;
+        if (image) added++;
+        free(pending[i].pixels);
+    }
+    free(pending);
+    return added;
+}
+
+int spark_graphics_atlas_get_page_count(const SparkAtlas* atlas) {
+    return atlas ? atlas->page_count : 0;
+}
+
+const lv_image_dsc_t* spark_graphics_atlas_get_page(const SparkAtlas* atlas, int page) {
+    if (!atlas || page < 0 || page >= atlas->page_count) return NULL;
+    return &atlas->pages[page]->image;
+}
+
+bool spark_graphics_atlas_get_region(const SparkAtlas* atlas, const lv_image_dsc_t* image,
+                                     int* page, int* x, int* y, int* w, int* h) {
+    if (!atlas || !image) return false;
+
+    for (const EntryBlock* block = atlas->blocks; block; block = block->next) {
+        const AtlasEntry* first = &block->entries[0];
+        if ((const void*)image < (const void*)first ||
+            (const void*)image >= (const void*)(first + block->count)) {
+            continue;
+        }
+
+        const AtlasEntry* entry = (const AtlasEntry*)image;
+        if (page) *page = entry->page;
+        if (x) *x = entry->x;
+        if (y) *y = entry->y;
+        if (w) *w = entry->image.header.w;
+        if (h) *h = entry->image.header.h;
+        return true;
+    }
+    return false;
+}
+
+void spark_graphics_atlas_get_stats(const SparkAtlas* atlas, SparkAtlasStats* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(SparkAtlasStats));
+    if (!atlas) return;
+
+    stats->pages = atlas->page_count;
+    stats->images = atlas->image_count;
+    for (int i = 0; i < atlas->page_count; i++) {
+        stats->used_pixels += atlas->pages[i]->used;
+        stats->page_pixels += (uint64_t)atlas->pages[i]->width * atlas->pages[i]->height;
+    }
+    if (stats->page_pixels > 0) {
+        stats->occupancy = (float)((double)stats->used_pixels / (double)stats->page_pixels);
+    }
+}
+
+float spark_graphics_atlas_get_page_occupancy(const SparkAtlas* atlas, int page) {
+    if (!atlas || page < 0 || page >= atlas->page_count) return 0.0f;
+    const AtlasPage* p = atlas->pages[page];
+    return (float)((double)p->used / ((double)p->width * p->height));
+}
@@ -0,0 +1,382 @@
+// blend.c
+#include "spark_graphics/blend.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// AVX2 is compiled per function and only used when the CPU reports it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SPARK_BLEND_AVX2 1
+#include <immintrin.h>
+#endif
+
+// Every mode composites the same way: the mode's color is mixed with the
+// source by destination alpha, then over the destination by the source's
+// share of the resulting alpha, so transparent destinations keep the
+// source color.
+
+static inline uint32_t div255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static inline uint32_t mode_channel(SparkBlendMode mode, uint32_t s, uint32_t d) {
+    switch (mode) {
+        case SPARK_BLEND_ADD: return s + d > 255 ? 255 : s + d;
+        case SPARK_BLEND_SUBTRACT: return d > s ? d - s : 0;
+        case SPARK_BLEND_MULTIPLY: return div255(s * d);
+        case SPARK_BLEND_SCREEN: return 255 - div255((255 - s) * (255 - d));
+        case SPARK_BLEND_OVERLAY:
+            return d < 128 ? div255(s * 2 * d) : 255 - div255((255 - s) * 2 * (255 - d));
+        default: return s;
+    }
+}
+
+static inline uint32_t blend_pixel(SparkBlendMode mode, uint32_t dst, uint32_t src) {
+    uint32_t sa = src >> 24;
+
+    if (mode == SPARK_BLEND_PREMULTIPLIED) {
+        uint32_t inv = 255 - sa;
+        uint32_t out = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t c = ((src >> shift) & 0xFF) + div255(((dst >> shift) & 0xFF) * inv);
+            out |= (c > 255 ? 255 : c) << shift;
+        }
+        return out;
+    }
+
+    if (sa == 0) return dst;
+    uint32_t da = dst >> 24;
+    uint32_t out_a = sa + div255(da * (255 - sa));
+    uint32_t w = (sa * 255 + out_a / 2) / out_a;
+
+    uint32_t out = out_a << 24;
+    for (int shift = 0; shift < 24; shift += 8) {
+        uint32_t s = (src >> shift) & 0xFF;
+        uint32_t d = (dst >> shift) & 0xFF;
+        uint32_t f = mode_channel(mode, s, d);
+        f = div255(s * (255 - da) + f * da);
+        out |= div255(d * (255 - w) + f * w) << shift;
+    }
+    return out;
+}
+
+static void blend_span_scalar(SparkBlendMode mode, uint32_t* dst, const uint32_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = blend_pixel(mode, dst[i], src[i]);
+    }
+}
+
+#if defined(__SSE2__)
+
+// Channels widen to 16-bit lanes, two pixels per register
+static inline __m128i div255_sse2(__m128i x) {
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+static inline __m128i lerp_sse2(__m128i a, __m128i b, __m128i w) {
+    __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), w);
+    return div255_sse2(_mm_add_epi16(_mm_mullo_epi16(a, inv), _mm_mullo_epi16(b, w)));
+}
+
+static inline __m128i mode_sse2(SparkBlendMode mode, __m128i s, __m128i d) {
+    const __m128i c255 = _mm_set1_epi16(255);
+    switch (mode) {
+        case SPARK_BLEND_ADD: return _mm_min_epi16(_mm_add_epi16(s, d), c255);
+        case SPARK_BLEND_SUBTRACT: return _mm_subs_epu16(d, s);
+        case SPARK_BLEND_MULTIPLY: return div255_sse2(_mm_mullo_epi16(s, d));
+        case SPARK_BLEND_SCREEN:
+            return _mm_sub_epi16(c255, div255_sse2(_mm_mullo_epi16(_mm_sub_epi16(c255, s),
+                                                                   _mm_sub_epi16(c255, d))));
+        case SPARK_BLEND_OVERLAY: {
+            // Both halves are computed, the unused one may wrap
+            __m128i inv_d = _mm_sub_epi16(c255, d);
+            __m128i low = div255_sse2(_mm_mullo_epi16(s, _mm_add_epi16(d, d)));
+            __m128i high = _mm_sub_epi16(c255, div255_sse2(_mm_mullo_epi16(_mm_sub_epi16(c255, s),
+                                                                           _mm_add_epi16(inv_d, inv_d))));
+            __m128i is_low = _mm_cmplt_epi16(d, _mm_set1_epi16(128));
+            return _mm_or_si128(_mm_and_si128(is_low, low), _mm_andnot_si128(is_low, high));
+        }
+        default: return s;
+    }
+}
+
+// Spreads one 16-bit value per pixel across that pixel's four channels
+static inline void broadcast_sse2(__m128i per_pixel, __m128i* lo, __m128i* hi) {
+    __m128i packed = _mm_packs_epi32(per_pixel, per_pixel);
+    __m128i pairs = _mm_unpacklo_epi16(packed, packed);
+    *lo = _mm_unpacklo_epi32(pairs, pairs);
+    *hi = _mm_unpackhi_epi32(pairs, pairs);
+}
+
+static inline __attribute__((always_inline))
+void span_sse2(SparkBlendMode mode, uint32_t* dst, const uint32_t* src, int count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c255 = _mm_set1_epi32(255);
+    const __m128i color_mask = _mm_set1_epi32(0x00FFFFFF);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i sa = _mm_srli_epi32(s, 24);
+        __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+        __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+        __m128i d_lo = _mm_unpacklo_epi8(d, zero);
+        __m128i d_hi = _mm_unpackhi_epi8(d, zero);
+
+        if (mode == SPARK_BLEND_PREMULTIPLIED) {
+            __m128i inv_lo, inv_hi;
+            broadcast_sse2(_mm_sub_epi32(c255, sa), &inv_lo, &inv_hi);
+            __m128i lo = _mm_add_epi16(s_lo, div255_sse2(_mm_mullo_epi16(d_lo, inv_lo)));
+            __m128i hi = _mm_add_epi16(s_hi, div255_sse2(_mm_mullo_epi16(d_hi, inv_hi)));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+            continue;
+        }
+
+        // Fully transparent sources leave dst alone, opaque normal ones replace it
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, zero)) == 0xFFFF) continue;
+        if (mode == SPARK_BLEND_NORMAL && _mm_movemask_epi8(_mm_cmpeq_epi32(sa, c255)) == 0xFFFF) {
+            _mm_storeu_si128((__m128i*)(dst + i), s);
+            continue;
+        }
+
+        // Alphas fit the low half of each 32-bit lane, so 16-bit math works on them
+        __m128i da = _mm_srli_epi32(d, 24);
+        __m128i out_a = _mm_add_epi32(sa, div255_sse2(_mm_mullo_epi16(da, _mm_sub_epi32(c255, sa))));
+        __m128 out_f = _mm_cvtepi32_ps(out_a);
+        __m128 w_f = _mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(sa), _mm_set1_ps(255.0f)), out_f);
+        w_f = _mm_and_ps(_mm_add_ps(w_f, _mm_set1_ps(0.5f)), _mm_cmpgt_ps(out_f, _mm_setzero_ps()));
+
+        // Rounds half up like the scalar path
+        __m128i w_lo, w_hi;
+        broadcast_sse2(_mm_cvttps_epi32(w_f), &w_lo, &w_hi);
+
+        __m128i f_lo = mode_sse2(mode, s_lo, d_lo);
+        __m128i f_hi = mode_sse2(mode, s_hi, d_hi);
+        if (mode != SPARK_BLEND_NORMAL) {
+            __m128i da_lo, da_hi;
+            broadcast_sse2(da, &da_lo, &da_hi);
+            f_lo = lerp_sse2(s_lo, f_lo, da_lo);
+            f_hi = lerp_sse2(s_hi, f_hi, da_hi);
+        }
+
+        __m128i out = _mm_packus_epi16(lerp_sse2(d_lo, f_lo, w_lo), lerp_sse2(d_hi, f_hi, w_hi));
+        out = _mm_or_si128(_mm_and_si128(out, color_mask), _mm_slli_epi32(out_a, 24));
+        _mm_storeu_si128((__m128i*)(dst + i), out);
+    }
+
+    for (; i < count; i++) {
+        dst[i] = blend_pixel(mode, dst[i], src[i]);
+    }
+}
+
+// Each mode gets its own copy of the loop with the mode folded in
+static void blend_span_sse2(SparkBlendMode mode, uint32_t* dst, const uint32_t* src, int count) {
+    switch (mode) {
+        case SPARK_BLEND_ADD: span_sse2(SPARK_BLEND_ADD, dst, src, count); break;
+        case SPARK_BLEND_MULTIPLY: span_sse2(SPARK_BLEND_MULTIPLY, dst, src, count); break;
+        case SPARK_BLEND_SCREEN: span_sse2(SPARK_BLEND_SCREEN, dst, src, count); break;
+        case SPARK_BLEND_SUBTRACT: span_sse2(SPARK_BLEND_SUBTRACT, dst, src, count); break;
+        case SPARK_BLEND_OVERLAY: span_sse2(SPARK_BLEND_OVERLAY, dst, src, count); break;
+        case SPARK_BLEND_PREMULTIPLIED: span_sse2(SPARK_BLEND_PREMULTIPLIED, dst, src, count); break;
+        default: span_sse2(SPARK_BLEND_NORMAL, dst, src, count); break;
+    }
+}
+
+#endif
+
+#if defined(SPARK_BLEND_AVX2)
+
+// Same as SSE2 on eight pixels. Unpacks and packs stay within 128-bit
+// lanes, so the per-pixel broadcast lines up the same way.
+#define AVX2 __attribute__((target("avx2")))
+
+static inline AVX2 __m256i div255_avx2(__m256i x) {
+    x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+static inline AVX2 __m256i lerp_avx2(__m256i a, __m256i b, __m256i w) {
+    __m256i inv = _mm256_sub_epi16(_mm256_set1_epi16(255), w);
+    return div255_avx2(_mm256_add_epi16(_mm256_mullo_epi16(a, inv), _mm256_mullo_epi16(b, w)));
+}
+
+static inline AVX2 __m256i mode_avx2(SparkBlendMode mode, __m256i s, __m256i d) {
+    const __m256i c255 = _mm256_set1_epi16(255);
+    switch (mode) {
+        case SPARK_BLEND_ADD: return _mm256_min_epi16(_mm256_add_epi16(s, d), c255);
+        case SPARK_BLEND_SUBTRACT: return _mm256_subs_epu16(d, s);
+        case SPARK_BLEND_MULTIPLY: return div255_avx2(_mm256_mullo_epi16(s, d));
+        case SPARK_BLEND_SCREEN:
+            return _mm256_sub_epi16(c255, div255_avx2(_mm256_mullo_epi16(_mm256_sub_epi16(c255, s),
+                                                                         _mm256_sub_epi16(c255, d))));
+        case SPARK_BLEND_OVERLAY: {
+            __m256i inv_d = _mm256_sub_epi16(c255, d);
+            __m256i low = div255_avx2(_mm256_mullo_epi16(s, _mm256_add_epi16(d, d)));
+            __m256i high = _mm256_sub_epi16(c255, div255_avx2(_mm256_mullo_epi16(_mm256_sub_epi16(c255, s),
+                                                                                 _mm256_add_epi16(inv_d, inv_d))));
+            __m256i is_low = _mm256_cmpgt_epi16(_mm256_set1_epi16(128), d);
+            return _mm256_blendv_epi8(high, low, is_low);
+        }
+        default: return s;
+    }
+}
+
+static inline AVX2 void broadcast_avx2(__m256i per_pixel, __m256i* lo, __m256i* hi) {
+    __m256i packed = _mm256_packs_epi32(per_pixel, per_pixel);
+    __m256i pairs = _mm256_unpacklo_epi16(packed, packed);
+    *lo = _mm256_unpacklo_epi32(pairs, pairs);
+    *hi = _mm256_unpackhi_epi32(pairs, pairs);
+}
+
+static inline AVX2 __attribute__((always_inline))
+void span_avx2(SparkBlendMode mode, uint32_t* dst, const uint32_t* src, int count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i c255 = _mm256_set1_epi32(255);
+    const __m256i color_mask = _mm256_set1_epi32(0x00FFFFFF);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i sa = _mm256_srli_epi32(s, 24);
+        __m256i s_lo = _mm256_unpacklo_epi8(s, zero);
+        __m256i s_hi = _mm256_unpackhi_epi8(s, zero);
+        __m256i d_lo = _mm256_unpacklo_epi8(d, zero);
+        __m256i d_hi = _mm256_unpackhi_epi8(d, zero);
+
+        if (mode == SPARK_BLEND_PREMULTIPLIED) {
+            __m256i inv_lo, inv_hi;
+            broadcast_avx2(_mm256_sub_epi32(c255, sa), &inv_lo, &inv_hi);
+            __m256i lo = _mm256_add_epi16(s_lo, div255_avx2(_mm256_mullo_epi16(d_lo, inv_lo)));
+            __m256i hi = _mm256_add_epi16(s_hi, div255_avx2(_mm256_mullo_epi16(d_hi, inv_hi)));
+            _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(lo, hi));
+            continue;
+        }
+
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(sa, zero)) == -1) continue;
+        if (mode == SPARK_BLEND_NORMAL && _mm256_movemask_epi8(_mm256_cmpeq_epi32(sa, c255)) == -1) {
+            _mm256_storeu_si256((__m256i*)(dst + i), s);
+            continue;
+        }
+
+        __m256i da = _mm256_srli_epi32(d, 24);
+        __m256i out_a = _mm256_add_epi32(sa, div255_avx2(_mm256_mullo_epi16(da, _mm256_sub_epi32(c255, sa))));
+        __m256 out_f = _mm256_cvtepi32_ps(out_a);
+        __m256 w_f = _mm256_div_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(sa), _mm256_set1_ps(255.0f)), out_f);
+        w_f = _mm256_and_ps(_mm256_add_ps(w_f, _mm256_set1_ps(0.5f)),
+                            _mm256_cmp_ps(out_f, _mm256_setzero_ps(), _CMP_GT_OQ));
+
+        __m256i w_lo, w_hi;
+        broadcast_avx2(_mm256_cvttps_epi32(w_f), &w_lo, &w_hi);
+
+        __m256i f_lo = mode_avx2(mode, s_lo, d_lo);
+        __m256i f_hi = mode_avx2(mode, s_hi, d_hi);
+        if (mode != SPARK_BLEND_NORMAL) {
+            __m256i da_lo, da_hi;
+            broadcast_avx2(da, &da_lo, &da_hi);
+            f_lo = lerp_avx2(s_lo, f_lo, da_lo);
+            f_hi = lerp_avx2(s_hi, f_hi, da_hi);
+        }
+
+        __m256i out = _mm256_packus_epi16(lerp_avx2(d_lo, f_lo, w_lo), lerp_avx2(d_hi, f_hi, w_hi));
+        out = _mm256_or_si256(_mm256_and_si256(out, color_mask), _mm256_slli_epi32(out_a, 24));
+        _mm256_storeu_si256((__m256i*)(dst + i), out);
+    }
+
+    for (; i < count; i++) {
+        dst[i] = blend_pixel(mode, dst[i], src[i]);
+    }
+}
+
+static AVX2 void blend_span_avx2(SparkBlendMode mode, uint32_t* dst, const uint32_t* src, int count) {
+    switch (mode) {
+        case SPARK_BLEND_ADD: span_avx2(SPARK_BLEND_ADD, dst, src, count); break;
+        case SPARK_BLEND_MULTIPLY: span_avx2(SPARK_BLEND_MULTIPLY, dst, src, count); break;
+        case SPARK_BLEND_SCREEN: span_avx2(SPARK_BLEND_SCREEN, dst, src, count); break;
+        case SPARK_BLEND_SUBTRACT: span_avx2(SPARK_BLEND_SUBTRACT, dst, src, count); break;
+        case SPARK_BLEND_OVERLAY: span_avx2(SPARK_BLEND_OVERLAY, dst, src, count); break;
+        case SPARK_BLEND_PREMULTIPLIED: span_avx2(SPARK_BLEND_PREMULTIPLIED, dst, src, count); break;
+        default: span_avx2(SPARK_BLEND_NORMAL, dst, src, count); break;
+    }
+}
+
+#undef AVX2
+#endif
+
+static struct {
+    bool detected;
+    SparkSimdLevel level;
+} simd = {0};
+
+static bool level_supported(SparkSimdLevel level) {
+    switch (level) {
+        case SPARK_SIMD_SCALAR:
+            return true;
+        case SPARK_SIMD_SSE2:
+#if defined(__SSE2__)
+            return true;
+#else
+            return false;
+#endif
+        case SPARK_SIMD_AVX2:
+#if defined(SPARK_BLEND_AVX2) && defined(__SSE2__)
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+SparkSimdLevel spark_graphics_get_simd_level(void) {
+    if (!simd.detected) {
+        simd.level = level_supported(SPARK_SIMD_AVX2) ? SPARK_SIMD_AVX2 :
+                     level_supported(SPARK_SIMD_SSE2) ? SPARK_SIMD_SSE2 : SPARK_SIMD_SCALAR;
+        simd.detected = true;
+    }
+    return simd.level;
+}
+
+bool spark_graphics_set_simd_level(SparkSimdLevel level) {
+    if (!level_supported(level)) return false;
+    simd.level = level;
+    simd.detected = true;
+    return true;
+}
+
+void spark_graphics_blend_span(SparkBlendMode mode, uint32_t* dst, const uint32_t* src, int count) {
+    if (!dst || !src || count <= 0) return;
+
+    switch (spark_graphics_get_simd_level()) {
+#if defined(SPARK_BLEND_AVX2) && defined(__SSE2__)
+        case SPARK_SIMD_AVX2:
+            blend_span_avx2(mode, dst, src, count);
+            return;
+#endif
+#if defined(__SSE2__)
+        case SPARK_SIMD_SSE2:
+            blend_span_sse2(mode, dst, src, count);
+            return;
+#endif
+        default:
+            blend_span_scalar(mode, dst, src, count);
+            return;
+    }
+}
+
+const char* spark_graphics_blend_mode_name(SparkBlendMode mode) {
+    switch (mode) {
+        case SPARK_BLEND_NORMAL: return "normal";
+        case SPARK_BLEND_ADD: return "add";
+        case SPARK_BLEND_MULTIPLY: return "multiply";
+        case SPARK_BLEND_SCREEN: return "screen";
+        case SPARK_BLEND_SUBTRACT: return "subtract";
+        case SPARK_BLEND_OVERLAY: return "overlay";
+        case SPARK_BLEND_PREMULTIPLIED: return "premultiplied";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,265 @@
+// canvas.c
+#include "spark_graphics/canvas.h"
+#include "spark_graphics/blend.h"
+#include "spark_graphics/layer.h"
+#include "../internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define MAX_DIRTY 8
+
+// Past MAX_DIRTY rectangles, new ones merge into the one that grows least
+typedef struct {
+    lv_area_t areas[MAX_DIRTY];
+    int count;
+} DirtyList;
+
+struct SparkCanvas {
+    SparkImageObject view;  // Shows the front buffer
+    int32_t width;
+    int32_t height;
+    int32_t stride;         // Pixels, rows padded to 16 bytes
+
+    uint32_t* front;        // Shown
+    uint32_t* back;         // Written while double buffered, otherwise NULL
+
+    // Double buffered: what the worker marked since the last swap, and what
+    // the frame before marked, which the back buffer is still missing
+    DirtyList pending;
+    DirtyList shown;
+};
+
+static void dirty_add(DirtyList* list, const lv_area_t* area) {
+    if (list->count < MAX_DIRTY) {
+        list->areas[list->count++] = *area;
+        return;
+    }
+
+    int best = 0;
+    uint32_t best_growth = UINT32_MAX;
+    for (int i = 0; i < list->count; i++) {
+        lv_area_t joined;
+        lv_area_join(&joined, &list->areas[i], area);
+        uint32_t growth = lv_area_get_size(&joined) - lv_area_get_size(&list->areas[i]);
+        if (growth < best_growth) {
+            best_growth = growth;
+            best = i;
+        }
+    }
+    lv_area_join(&list->areas[best], &list->areas[best], area);
+}
+
+static void invalidate(SparkCanvas* canvas, const lv_area_t* area) {
+    if (!canvas->view.object) return;
+
+    lv_area_t coords;
+    lv_obj_get_coords(canvas->view.object, &coords);
+    lv_area_t screen = *area;
+    lv_area_move(&screen, coords.x1, coords.y1);
+    lv_obj_invalidate_area(canvas->view.object, &screen);
+}
+
+// Single-buffered changes redraw right away, attributed to the public call.
+// Double-buffered ones wait for the swap and stay off LVGL and the debug
+// tracker, since a worker thread may be writing.
+static void touch(SparkCanvas* canvas, const lv_area_t* area, const char* function) {
+    if (canvas->back) {
+        dirty_add(&canvas->pending, area);
+        return;
+    }
+
+    SparkTraceScope scope = spark_debug_trace_begin(function, canvas->view.object);
+    invalidate(canvas, area);
+    canvas->view.changed = true;
+    spark_debug_trace_end(&scope);
+}
+
+static bool clip(const SparkCanvas* canvas, int x, int y, int w, int h, lv_area_t* area) {
+    if (w <= 0 || h <= 0) return false;
+    lv_area_t bounds = { 0, 0, canvas->width - 1, canvas->height - 1 };
+    lv_area_t rect = { x, y, x + w - 1, y + h - 1 };
+    return lv_area_intersect(area, &rect, &bounds);
+}
+
+static uint32_t* write_buffer(SparkCanvas* canvas) {
+    return canvas->back ? canvas->back : canvas->front;
+}
+
+static void fill_span(uint32_t* dst, int count, uint32_t color) {
+    int i = 0;
+
+#if defined(__SSE2__)
+    const __m128i value = _mm_set1_epi32((int)color);
+    for (; i + 16 <= count; i += 16) {
+        _mm_storeu_si128((__m128i*)(dst + i), value);
+        _mm_storeu_si128((__m128i*)(dst + i + 4), value);
+        _mm_storeu_si128((__m128i*)(dst + i + 8), value);
+        _mm_storeu_si128((__m128i*)(dst + i + 12), value);
+    }
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i*)(dst + i), value);
+    }
+#endif
+
+    for (; i < count; i++) {
+        dst[i] = color;
+    }
+}
+
+SparkCanvas* spark_graphics_canvas_new(float x, float y, float w, float h, bool double_buffered) {
+    if (w < 1.0f || h < 1.0f) return NULL;
+
+    SparkCanvas* canvas = calloc(1, sizeof(SparkCanvas));
+    if (!canvas) return NULL;
+
+    canvas->width = (int32_t)w;
+    canvas->height = (int32_t)h;
+    canvas->stride = (canvas->width + 3) & ~3;
+
+    size_t pixels = (size_t)canvas->stride * canvas->height;
+    canvas->front = calloc(pixels, 4);
+    if (double_buffered) canvas->back = calloc(pixels, 4);
+    bool created = spark_image_object_create(&canvas->view, x, y, NULL, NULL);
+    if (!canvas->front || (double_buffered && !canvas->back) || !created) {
+        spark_image_object_free(&canvas->view);
+        free(canvas->front);
+        free(canvas->back);
+        free(canvas);
+        return NULL;
+    }
+
+    spark_image_object_set_pixels(&canvas->view, canvas->front, canvas->width, canvas->height, canvas->stride);
+    return canvas;
+}
+
+void spark_graphics_canvas_free(SparkCanvas* canvas) {
+    if (!canvas) return;
+    spark_image_object_free(&canvas->view);
+    free(canvas->front);
+    free(canvas->back);
+    free(canvas);
+}
+
+lv_obj_t* spark_graphics_canvas_get_object(SparkCanvas* canvas) {
+    return canvas ? canvas->view.object : NULL;
+}
+
+bool spark_graphics_canvas_get_buffer(SparkCanvas* canvas, SparkCanvasBuffer* buffer) {
+    if (!canvas || !buffer) return false;
+    buffer->pixels = write_buffer(canvas);
+    buffer->width = canvas->width;
+    buffer->height = canvas->height;
+    buffer->stride = canvas->stride;
+    buffer->format = LV_COLOR_FORMAT_ARGB8888;
+    return true;
+}
+
+void spark_graphics_canvas_mark_dirty(SparkCanvas* canvas, int x, int y, int w, int h) {
+    lv_area_t area;
+    if (!canvas || !clip(canvas, x, y, w, h, &area)) return;
+    touch(canvas, &area, __func__);
+}
+
+void spark_graphics_canvas_swap(SparkCanvas* canvas) {
+    if (!canvas || !canvas->back) return;
+    SPARK_TRACE_INVALIDATION(canvas->view.object);
+
+    uint32_t* shown = canvas->front;
+    canvas->front = canvas->back;
+    canvas->back = shown;
+    spark_image_object_set_pixels(&canvas->view, canvas->front, canvas->width, canvas->height, canvas->stride);
+
+    // The new front differs from the old one where either frame drew
+    for (int i = 0; i < canvas->pending.count; i++) invalidate(canvas, &canvas->pending.areas[i]);
+    for (int i = 0; i < canvas->shown.count; i++) invalidate(canvas, &canvas->shown.areas[i]);
+    canvas->shown = canvas->pending;
+    canvas->pending.count = 0;
+}
+
+void spark_graphics_canvas_clear(SparkCanvas* canvas, uint32_t color) {
+    if (!canvas) return;
+
+    // Padding included, the rows are one contiguous span
+    fill_span(write_buffer(canvas), canvas->stride * canvas->height, color);
+    lv_area_t area = { 0, 0, canvas->width - 1, canvas->height - 1 };
+    touch(canvas, &area, __func__);
+}
+
+static void fill(SparkCanvas* canvas, const lv_area_t* area, uint32_t color, const char* function) {
+    uint32_t* pixels = write_buffer(canvas);
+    int32_t w = lv_area_get_width(area);
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        fill_span(pixels + (size_t)y * canvas->stride + area->x1, w, color);
+    }
+    touch(canvas, area, function);
+}
+
+void spark_graphics_canvas_fill_rect(SparkCanvas* canvas, int x, int y, int w, int h, uint32_t color) {
+    lv_area_t area;
+    if (!canvas || !clip(canvas, x, y, w, h, &area)) return;
+    fill(canvas, &area, color, __func__);
+}
+
+void spark_graphics_canvas_hline(SparkCanvas* canvas, int x, int y, int length, uint32_t color) {
+    lv_area_t area;
+    if (!canvas || !clip(canvas, x, y, length, 1, &area)) return;
+    fill(canvas, &area, color, __func__);
+}
+
+void spark_graphics_canvas_vline(SparkCanvas* canvas, int x, int y, int length, uint32_t color) {
+    lv_area_t area;
+    if (!canvas || !clip(canvas, x, y, 1, length, &area)) return;
+    fill(canvas, &area, color, __func__);
+}
+
+// Source rows are stride pixels apart, clipped against the canvas
+static void blit(SparkCanvas* canvas, int x, int y, const uint32_t* src, int32_t src_stride,
+                 int32_t w, int32_t h, const char* function) {
+    lv_area_t area;
+    if (!clip(canvas, x, y, w, h, &area)) return;
+
+    SparkBlendMode mode = spark_graphics_get_blend_mode();
+    uint32_t* pixels = write_buffer(canvas);
+    int32_t width = lv_area_get_width(&area);
+    const uint32_t* row = src + (size_t)(area.y1 - y) * src_stride + (area.x1 - x);
+
+    for (int32_t py = area.y1; py <= area.y2; py++) {
+        spark_graphics_blend_span(mode, pixels + (size_t)py * canvas->stride + area.x1, row, width);
+        row += src_stride;
+    }
+    touch(canvas, &area, function);
+}
+
+void spark_graphics_canvas_blit(SparkCanvas* canvas, int x, int y, const SparkCanvas* source) {
+    if (!canvas || !source) return;
+    if (source == canvas) {
+        fprintf(stderr, "Canvas can't blit onto itself\n");
+        return;
+    }
+    blit(canvas, x, y, source->front, source->stride, source->width, source->height, __func__);
+}
+
+void spark_graphics_canvas_blit_image(SparkCanvas* canvas, int x, int y, const lv_image_dsc_t* image) {
+    if (!canvas || !image) return;
+
+    if (image->header.cf == LV_COLOR_FORMAT_ARGB8888 && image->data) {
+        int32_t stride = image->header.stride ? (int32_t)image->header.stride / 4 : (int32_t)image->header.w;
+        blit(canvas, x, y, (const uint32_t*)image->data, stride,
+             (int32_t)image->header.w, (int32_t)image->header.h, __func__);
+        return;
+    }
+
+    int32_t w, h;
+    uint32_t* pixels = spark_image_decode_argb8888(image, &w, &h);
+    if (!pixels) {
+        fprintf(stderr, "Failed to decode image for canvas blit\n");
+        return;
+    }
+    blit(canvas, x, y, pixels, w, w, h, __func__);
+    free(pixels);
+}
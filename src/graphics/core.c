@@ -1,17 +1,31 @@
 #include "spark_graphics/core.h"
+#include "spark_graphics/blend.h"
 #include "../internal.h"
+#include <math.h>
+#include <stdio.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define STACK_DEPTH 64
 
 typedef struct {
+    SparkTransform transform;
     float origin_x, origin_y;
     SparkBlendMode blend_mode;
 } GraphicsState;
 
 static GraphicsState current_state = {
+    .transform = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
     .origin_x = 0.0f,
     .origin_y = 0.0f,
     .blend_mode = SPARK_BLEND_NORMAL
 };
 
+static GraphicsState state_stack[STACK_DEPTH];
+static int stack_depth = 0;
+
 void spark_graphics_clear(void) {
     lv_obj_t* scr = lv_screen_active();
     if (!scr) return;
@@ -19,23 +33,97 @@ void spark_graphics_clear(void) {
 }
 
 void spark_graphics_push(void) {
-    // Store current state - will be implemented with a state stack
+    if (stack_depth == STACK_DEPTH) {
+        fprintf(stderr, "spark_graphics_push: stack overflow, more than %d pushes\n", STACK_DEPTH);
+        return;
+    }
+    state_stack[stack_depth++] = current_state;
 }
 
 void spark_graphics_pop(void) {
-    // Restore previous state from stack
+    if (stack_depth == 0) {
+        fprintf(stderr, "spark_graphics_pop: no matching push\n");
+        return;
+    }
+    current_state = state_stack[--stack_depth];
 }
 
+// Each operation applies to local coordinates before the current transform
 void spark_graphics_translate(float x, float y) {
-    // Apply translation transform to current drawing context
+    SparkTransform* t = &current_state.transform;
+    t->tx += t->a * x + t->c * y;
+    t->ty += t->b * x + t->d * y;
 }
 
 void spark_graphics_rotate(float angle) {
-    // Apply rotation transform to current drawing context  
+    SparkTransform* t = &current_state.transform;
+    float cs = cosf(angle);
+    float sn = sinf(angle);
+    float a = t->a, b = t->b;
+    t->a = a * cs + t->c * sn;
+    t->b = b * cs + t->d * sn;
+    t->c = t->c * cs - a * sn;
+    t->d = t->d * cs - b * sn;
 }
 
 void spark_graphics_scale(float sx, float sy) {
-    // Apply scale transform to current drawing context
+    SparkTransform* t = &current_state.transform;
+    t->a *= sx;
+    t->b *= sx;
+    t->c *= sy;
+    t->d *= sy;
+}
+
+void spark_graphics_reset_transform(void) {
+    current_state.transform = (SparkTransform){ 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+}
+
+const SparkTransform* spark_graphics_get_transform(void) {
+    return &current_state.transform;
+}
+
+bool spark_transform_is_identity(const SparkTransform* t) {
+    return t->a == 1.0f && t->b == 0.0f && t->c == 0.0f && t->d == 1.0f &&
+           t->tx == 0.0f && t->ty == 0.0f;
+}
+
+void spark_transform_apply(const SparkTransform* t, const float* xy, float* out, int count) {
+    int i = 0;
+
+#if defined(__SSE2__)
+    // Two points per register: x' and y' come out interleaved like the input
+    const __m128 column_x = _mm_setr_ps(t->a, t->b, t->a, t->b);
+    const __m128 column_y = _mm_setr_ps(t->c, t->d, t->c, t->d);
+    const __m128 offset = _mm_setr_ps(t->tx, t->ty, t->tx, t->ty);
+
+    for (; i + 2 <= count; i += 2) {
+        __m128 p = _mm_loadu_ps(xy + i * 2);
+        __m128 xs = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 ys = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, column_x), _mm_mul_ps(ys, column_y)), offset);
+        _mm_storeu_ps(out + i * 2, r);
+    }
+#endif
+
+    for (; i < count; i++) {
+        float x = xy[i * 2];
+        float y = xy[i * 2 + 1];
+        out[i * 2] = t->a * x + t->c * y + t->tx;
+        out[i * 2 + 1] = t->b * x + t->d * y + t->ty;
+    }
+}
+
+void spark_graphics_transform_points(const float* xy, float* out, int count) {
+    if (!xy || !out || count <= 0) return;
+    spark_transform_apply(&current_state.transform, xy, out, count);
+}
+
+void spark_graphics_begin_frame(void) {
+    if (stack_depth > 0) {
+        fprintf(stderr, "spark.draw: %d push without pop\n", stack_depth);
+        stack_depth = 0;
+    }
+    spark_graphics_reset_transform();
 }
 
 void spark_graphics_set_origin(float x, float y) {
@@ -48,28 +136,33 @@ void spark_graphics_reset_origin(void) {
     current_state.origin_y = 0.0f;
 }
 
+// Applies to shapes drawn from now on, not to what is already on screen.
+// Canvases and sprite batches blend every mode in software; LVGL-drawn
+// shapes, retained or in draw lists, only add, subtract and multiply, and
+// draw the others as normal.
 void spark_graphics_set_blend_mode(SparkBlendMode mode) {
+    if (mode < SPARK_BLEND_NORMAL || mode >= SPARK_BLEND_MODE_COUNT) return;
     current_state.blend_mode = mode;
-    
-    // Map to LVGL blend mode
-    lv_blend_mode_t lvgl_mode;
-    switch(mode) {
-        case SPARK_BLEND_ADD:
-            lvgl_mode = LV_BLEND_MODE_ADDITIVE; 
-            break;
-        case SPARK_BLEND_MULTIPLY:
-            lvgl_mode = LV_BLEND_MODE_MULTIPLY;
-            break;
-        case SPARK_BLEND_SCREEN:
-        case SPARK_BLEND_NORMAL:
-        default:
-            lvgl_mode = LV_BLEND_MODE_NORMAL;
-            break;
-    }
+}
 
-    // Apply blend mode to screen
-    lv_obj_t* scr = lv_screen_active();
-    if (scr) {
-        lv_obj_set_style_blend_mode(scr, lvgl_mode, LV_PART_MAIN);
+SparkBlendMode spark_graphics_get_blend_mode(void) {
+    return current_state.blend_mode;
+}
+
+lv_blend_mode_t spark_blend_mode_to_lvgl(SparkBlendMode mode) {
+    static bool warned[SPARK_BLEND_MODE_COUNT];
+
+    switch (mode) {
+        case SPARK_BLEND_NORMAL: return LV_BLEND_MODE_NORMAL;
+        case SPARK_BLEND_ADD: return LV_BLEND_MODE_ADDITIVE;
+        case SPARK_BLEND_SUBTRACT: return LV_BLEND_MODE_SUBTRACTIVE;
+        case SPARK_BLEND_MULTIPLY: return LV_BLEND_MODE_MULTIPLY;
+        default:
+            if (mode < SPARK_BLEND_MODE_COUNT && !warned[mode]) {
+                warned[mode] = true;
+                fprintf(stderr, "Blend mode %s isn't supported for shapes, drawing them as normal\n",
+                        spark_graphics_blend_mode_name(mode));
+            }
+            return LV_BLEND_MODE_NORMAL;
     }
-}   
\ No newline at end of file
+}
@@ -0,0 +1,660 @@
+// draw.c
+#include "spark_graphics/draw.h"
+#include "spark_graphics/color.h"
+#include "spark_graphics/layer.h"
+#include "../internal.h"
+#include "src/draw/lv_draw_private.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 64
+#define PI 3.14159265358979323846f
+
+// Below this a transform component counts as zero
+#define AXIS_EPSILON 1e-5f
+
+// Ellipse masks kept per list, one per distinct size and fill
+#define ELLIPSE_MASKS 16
+
+// A8 coverage of an ellipse, drawn recolored like a polygon's mask
+typedef struct EllipseMask {
+    lv_image_dsc_t image;
+    uint8_t* data;
+    int32_t w;
+    int32_t h;
+    bool filled;
+    uint32_t pass;      // Draw pass that last used it
+} EllipseMask;
+
+struct SparkDrawList {
+    lv_obj_t* object;
+    SparkDrawCommand* commands;
+    int count;
+    int capacity;
+
+    // Commands of the last begin/end pass, diffed to find what to redraw
+    SparkDrawCommand* previous;
+    int previous_count;
+    int previous_capacity;
+    bool building;
+    bool background;    // Kept below retained objects
+
+    // LVGL only rounds rectangles, so unequal radii draw from these
+    EllipseMask ellipses[ELLIPSE_MASKS];
+    int ellipse_count;
+    uint32_t draw_pass;
+};
+
+static struct {
+    SparkDrawList* target;
+    SparkDrawList* default_list;
+    SparkDrawList* frame_list;  // Rebuilt by spark.draw every frame
+} draw = {0};
+
+static bool reserve(SparkDrawCommand** commands, int* capacity, int needed) {
+    if (needed <= *capacity) return true;
+
+    int new_capacity = *capacity > 0 ? *capacity : INITIAL_CAPACITY;
+    while (new_capacity < needed) new_capacity *= 2;
+
+    SparkDrawCommand* grown = realloc(*commands, sizeof(SparkDrawCommand) * new_capacity);
+    if (!grown) return false;
+    *commands = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+// Text commands hold a reference on their run while in a list
+static void retain_command(const SparkDrawCommand* command) {
+    if (command->shape == SPARK_DRAW_TEXT) spark_text_run_retain(command->text);
+}
+
+static void release_commands(const SparkDrawCommand* commands, int count) {
+    for (int i = 0; i < count; i++) {
+        if (commands[i].shape == SPARK_DRAW_TEXT) spark_text_run_release(commands[i].text);
+    }
+}
+
+static int32_t line_width(const SparkDrawCommand* command) {
+    return command->radius > 1.0f ? (int32_t)(command->radius + 0.5f) : 1;
+}
+
+// Upright box of a rectangle or ellipse, relative to the list object
+static lv_area_t command_box(const SparkDrawCommand* command) {
+    lv_area_t area;
+    area.x1 = (int32_t)command->x;
+    area.y1 = (int32_t)command->y;
+    area.x2 = area.x1 + (int32_t)command->w - 1;
+    area.y2 = area.y1 + (int32_t)command->h - 1;
+    return area;
+}
+
+// Area a command covers, relative to the list object
+static lv_area_t command_bounds(const SparkDrawCommand* command) {
+    lv_area_t area;
+    switch (command->shape) {
+        case SPARK_DRAW_LINE: {
+            // Widened by half the stroke and a pixel for the anti-aliased edge
+            int32_t pad = line_width(command) / 2 + 1;
+            area.x1 = (int32_t)floorf(fminf(command->x, command->w)) - pad;
+            area.y1 = (int32_t)floorf(fminf(command->y, command->h)) - pad;
+            area.x2 = (int32_t)ceilf(fmaxf(command->x, command->w)) + pad;
+            area.y2 = (int32_t)ceilf(fmaxf(command->y, command->h)) + pad;
+            break;
+        }
+        case SPARK_DRAW_POINT:
+            area.x1 = area.x2 = (int32_t)command->x;
+            area.y1 = area.y2 = (int32_t)command->y;
+            break;
+        default:
+            if (command->rotation == 0) return command_box(command);
+
+            // Axis-aligned box around the rotated one
+            float angle = (float)command->rotation * (PI / 1800.0f);
+            float cs = fabsf(cosf(angle));
+            float sn = fabsf(sinf(angle));
+            float half_w = (cs * command->w + sn * command->h) / 2;
+            float half_h = (sn * command->w + cs * command->h) / 2;
+            float cx = command->x + command->w / 2;
+            float cy = command->y + command->h / 2;
+            area.x1 = (int32_t)floorf(cx - half_w) - 1;
+            area.y1 = (int32_t)floorf(cy - half_h) - 1;
+            area.x2 = (int32_t)ceilf(cx + half_w) + 1;
+            area.y2 = (int32_t)ceilf(cy + half_h) + 1;
+            break;
+    }
+    return area;
+}
+
+// Rendered upright into a layer the size of the shape, then blitted rotated
+static void draw_rotated(lv_layer_t* layer, const lv_draw_rect_dsc_t* rect, const lv_area_t* box,
+                         int16_t rotation) {
+    lv_layer_t* shape_layer = lv_draw_layer_create(layer, LV_COLOR_FORMAT_ARGB8888, box);
+    if (!shape_layer) return;
+
+    // The blend applies when the layer lands, not inside it
+    lv_draw_rect_dsc_t upright = *rect;
+    upright.blend_mode = LV_BLEND_MODE_NORMAL;
+    lv_draw_rect(shape_layer, &upright, box);
+
+    lv_draw_image_dsc_t image;
+    lv_draw_image_dsc_init(&image);
+    image.src = shape_layer;
+    image.blend_mode = rect->blend_mode;
+    image.rotation = rotation;
+    image.pivot.x = lv_area_get_width(box) / 2;
+    image.pivot.y = lv_area_get_height(box) / 2;
+    image.antialias = 1;
+    lv_draw_layer(layer, &image, box);
+}
+
+// Signed distance to the ellipse edge in pixels, estimated from the
+// implicit function over its gradient; exact on the axes and close enough
+// elsewhere for one pixel of anti-aliasing.
+static float ellipse_distance(float x, float y, float rx, float ry) {
+    float nx = x / (rx * rx);
+    float ny = y / (ry * ry);
+    float gradient = 2.0f * sqrtf(nx * nx + ny * ny);
+    if (gradient < AXIS_EPSILON) return -fminf(rx, ry);
+    return (x * nx + y * ny - 1.0f) / gradient;
+}
+
+static void rasterize_ellipse(EllipseMask* mask, uint32_t stride) {
+    float rx = (float)mask->w / 2;
+    float ry = (float)mask->h / 2;
+    for (int32_t y = 0; y < mask->h; y++) {
+        uint8_t* row = mask->data + (size_t)y * stride;
+        for (int32_t x = 0; x < mask->w; x++) {
+            float d = ellipse_distance((float)x + 0.5f - rx, (float)y + 0.5f - ry, rx, ry);
+            float coverage = fminf(fmaxf(0.5f - d, 0.0f), 1.0f);
+            // Outlines are the one pixel between the edge and an edge inset by a pixel
+            if (!mask->filled) coverage -= fminf(fmaxf(-0.5f - d, 0.0f), 1.0f);
+            row[x] = (uint8_t)(coverage * 255.0f + 0.5f);
+        }
+    }
+}
+
+// Reuses a mask of the same size, otherwise fills a free slot or the one
+// used longest ago. Masks this pass already queued are never replaced.
+static EllipseMask* get_ellipse_mask(SparkDrawList* list, int32_t w, int32_t h, bool filled) {
+    EllipseMask* mask = NULL;
+    for (int i = 0; i < list->ellipse_count; i++) {
+        EllipseMask* candidate = &list->ellipses[i];
+        if (candidate->w == w && candidate->h == h && candidate->filled == filled) {
+            candidate->pass = list->draw_pass;
+            return candidate;
+        }
+        if (candidate->pass != list->draw_pass && (!mask || candidate->pass < mask->pass)) mask = candidate;
+    }
+    if (list->ellipse_count < ELLIPSE_MASKS) {
+        mask = &list->ellipses[list->ellipse_count];
+    }
+    if (!mask) return NULL;
+
+    uint32_t stride = lv_draw_buf_width_to_stride(w, LV_COLOR_FORMAT_A8);
+    size_t size = (size_t)stride * h;
+    uint8_t* data = realloc(mask->data, size);
+    if (!data) return NULL;
+
+    if (mask == &list->ellipses[list->ellipse_count]) {
+        list->ellipse_count++;
+    } else {
+        // LVGL caches decoded images and headers by source pointer
+        lv_image_cache_drop(&mask->image);
+        lv_image_header_cache_drop(&mask->image);
+    }
+    mask->data = data;
+    mask->w = w;
+    mask->h = h;
+    mask->filled = filled;
+    mask->pass = list->draw_pass;
+    rasterize_ellipse(mask, stride);
+
+    mask->image.header.magic = LV_IMAGE_HEADER_MAGIC;
+    mask->image.header.cf = LV_COLOR_FORMAT_A8;
+    mask->image.header.w = w;
+    mask->image.header.h = h;
+    mask->image.header.stride = stride;
+    mask->image.data = data;
+    mask->image.data_size = (uint32_t)size;
+    return mask;
+}
+
+static void free_ellipse_masks(SparkDrawList* list) {
+    for (int i = 0; i < list->ellipse_count; i++) {
+        lv_image_cache_drop(&list->ellipses[i].image);
+        lv_image_header_cache_drop(&list->ellipses[i].image);
+        free(list->ellipses[i].data);
+    }
+    list->ellipse_count = 0;
+}
+
+// Rotation turns the mask itself, no intermediate layer needed
+static bool draw_ellipse(lv_layer_t* layer, SparkDrawList* list, const SparkDrawCommand* command,
+                         const lv_area_t* box) {
+    EllipseMask* mask = get_ellipse_mask(list, lv_area_get_width(box), lv_area_get_height(box),
+                                         command->filled);
+    if (!mask) return false;
+
+    lv_draw_image_dsc_t image;
+    lv_draw_image_dsc_init(&image);
+    image.src = &mask->image;
+    image.recolor = command->color;
+    image.recolor_opa = LV_OPA_COVER;
+    image.opa = command->opa;
+    image.blend_mode = spark_blend_mode_to_lvgl((SparkBlendMode)command->blend_mode);
+    image.rotation = command->rotation;
+    image.pivot.x = mask->w / 2;
+    image.pivot.y = mask->h / 2;
+    image.antialias = 1;
+    lv_draw_image(layer, &image, box);
+    return true;
+}
+
+// The run's text is drawn in place, LVGL doesn't copy it
+static void draw_text(lv_layer_t* layer, lv_draw_label_dsc_t* label, const SparkDrawCommand* command,
+                      const lv_area_t* area) {
+    if (!spark_text_run_get(command->text, &label->text, &label->font, &label->align, NULL, NULL)) return;
+    label->color = command->color;
+    label->opa = command->opa;
+    label->blend_mode = spark_blend_mode_to_lvgl((SparkBlendMode)command->blend_mode);
+    lv_draw_label(layer, label, area);
+}
+
+static void draw_event_cb(lv_event_t* e) {
+    SparkDrawList* list = lv_event_get_user_data(e);
+    lv_layer_t* layer = lv_event_get_layer(e);
+
+    lv_area_t origin;
+    lv_obj_get_coords(list->object, &origin);
+
+    // Set up once, only the fields a command changes are rewritten
+    lv_draw_rect_dsc_t rect;
+    lv_draw_rect_dsc_init(&rect);
+    lv_draw_line_dsc_t line;
+    lv_draw_line_dsc_init(&line);
+    lv_draw_label_dsc_t label;
+    lv_draw_label_dsc_init(&label);
+    spark.draw_layer = layer;
+    list->draw_pass++;
+
+    for (int i = 0; i < list->count; i++) {
+        const SparkDrawCommand* command = &list->commands[i];
+        if (command->opa == LV_OPA_TRANSP) continue;
+
+        lv_area_t area = command_bounds(command);
+        lv_area_move(&area, origin.x1, origin.y1);
+
+        // Skip commands outside the area being redrawn before LVGL queues a task
+        if (!lv_area_is_on(&area, &layer->_clip_area)) continue;
+
+        if (command->shape == SPARK_DRAW_TEXT) {
+            draw_text(layer, &label, command, &area);
+            continue;
+        }
+
+        if (command->shape == SPARK_DRAW_LINE) {
+            line.p1.x = (lv_value_precise_t)(command->x + origin.x1);
+            line.p1.y = (lv_value_precise_t)(command->y + origin.y1);
+            line.p2.x = (lv_value_precise_t)(command->w + origin.x1);
+            line.p2.y = (lv_value_precise_t)(command->h + origin.y1);
+            line.color = command->color;
+            line.opa = command->opa;
+            line.width = line_width(command);
+            line.blend_mode = spark_blend_mode_to_lvgl((SparkBlendMode)command->blend_mode);
+            lv_draw_line(layer, &line);
+            continue;
+        }
+
+        lv_area_t box = command_box(command);
+        lv_area_move(&box, origin.x1, origin.y1);
+        bool circle = lv_area_get_width(&box) == lv_area_get_height(&box);
+        if (command->shape == SPARK_DRAW_ELLIPSE && !circle && lv_area_get_width(&box) > 0 &&
+            lv_area_get_height(&box) > 0 && draw_ellipse(layer, list, command, &box)) {
+            continue;
+        }
+
+        rect.radius = command->shape == SPARK_DRAW_ELLIPSE ? LV_RADIUS_CIRCLE : (int32_t)command->radius;
+        rect.blend_mode = spark_blend_mode_to_lvgl((SparkBlendMode)command->blend_mode);
+        if (command->filled || command->shape == SPARK_DRAW_POINT) {
+            rect.bg_color = command->color;
+            rect.bg_opa = command->opa;
+            rect.border_width = 0;
+        } else {
+            rect.bg_opa = LV_OPA_TRANSP;
+            rect.border_color = command->color;
+            rect.border_opa = command->opa;
+            rect.border_width = 1;
+        }
+
+        if (command->rotation != 0) {
+            draw_rotated(layer, &rect, &box, command->rotation);
+            continue;
+        }
+        lv_draw_rect(layer, &rect, &area);
+    }
+    spark.draw_layer = NULL;
+}
+
+static void delete_event_cb(lv_event_t* e) {
+    SparkDrawList* list = lv_event_get_user_data(e);
+    list->object = NULL;
+}
+
+// Lists outlive their object, spark_graphics_clear deletes it with the rest
+static bool ensure_object(SparkDrawList* list) {
+    if (list->object) return true;
+
+    lv_obj_t* object = lv_obj_create(spark_graphics_get_current_layer());
+    if (!object) return false;
+
+    lv_obj_remove_style_all(object);
+    lv_obj_set_size(object, lv_pct(100), lv_pct(100));
+    lv_obj_remove_flag(object, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(object, LV_OBJ_FLAG_IGNORE_LAYOUT);
+    lv_obj_add_event_cb(object, draw_event_cb, LV_EVENT_DRAW_MAIN, list);
+    lv_obj_add_event_cb(object, delete_event_cb, LV_EVENT_DELETE, list);
+    if (list->background) lv_obj_move_background(object);
+    list->object = object;
+    return true;
+}
+
+static void invalidate_command(SparkDrawList* list, const SparkDrawCommand* command) {
+    if (!list->object || command->opa == LV_OPA_TRANSP) return;
+
+    lv_area_t origin;
+    lv_obj_get_coords(list->object, &origin);
+    lv_area_t area = command_bounds(command);
+    lv_area_move(&area, origin.x1, origin.y1);
+    lv_obj_invalidate_area(list->object, &area);
+}
+
+SparkDrawList* spark_draw_list_new(void) {
+    SparkDrawList* list = calloc(1, sizeof(SparkDrawList));
+    if (!list) return NULL;
+
+    if (!ensure_object(list)) {
+        free(list);
+        return NULL;
+    }
+    return list;
+}
+
+void spark_draw_list_free(SparkDrawList* list) {
+    if (!list) return;
+    if (list->object) lv_obj_delete(list->object);
+    if (draw.target == list) draw.target = NULL;
+    if (draw.default_list == list) draw.default_list = NULL;
+    if (draw.frame_list == list) draw.frame_list = NULL;
+    release_commands(list->commands, list->count);
+    release_commands(list->previous, list->previous_count);
+    free_ellipse_masks(list);
+    free(list->commands);
+    free(list->previous);
+    free(list);
+}
+
+void spark_draw_list_clear(SparkDrawList* list) {
+    if (!list) return;
+    SPARK_TRACE_INVALIDATION(list->object);
+    if (list->object && list->count > 0) lv_obj_invalidate(list->object);
+    release_commands(list->commands, list->count);
+    release_commands(list->previous, list->previous_count);
+    list->count = 0;
+    list->previous_count = 0;
+}
+
+int spark_draw_list_get_count(const SparkDrawList* list) {
+    return list ? list->count : 0;
+}
+
+lv_obj_t* spark_draw_list_get_object(const SparkDrawList* list) {
+    return list ? list->object : NULL;
+}
+
+void spark_draw_list_begin(SparkDrawList* list) {
+    if (!list) return;
+
+    // Keep this pass's commands to diff against at end
+    release_commands(list->previous, list->previous_count);
+    SparkDrawCommand* commands = list->previous;
+    int capacity = list->previous_capacity;
+    list->previous = list->commands;
+    list->previous_capacity = list->capacity;
+    list->previous_count = list->count;
+    list->commands = commands;
+    list->capacity = capacity;
+    list->count = 0;
+    list->building = true;
+}
+
+void spark_draw_list_end(SparkDrawList* list) {
+    if (!list || !list->building) return;
+    list->building = false;
+    if (!ensure_object(list)) return;
+    SPARK_TRACE_INVALIDATION(list->object);
+
+    // Only commands that changed redraw, LVGL merges the areas
+    int count = list->count > list->previous_count ? list->count : list->previous_count;
+    for (int i = 0; i < count; i++) {
+        const SparkDrawCommand* current = i < list->count ? &list->commands[i] : NULL;
+        const SparkDrawCommand* previous = i < list->previous_count ? &list->previous[i] : NULL;
+        if (current && previous && memcmp(current, previous, sizeof(SparkDrawCommand)) == 0) continue;
+
+        if (previous) invalidate_command(list, previous);
+        if (current) invalidate_command(list, current);
+    }
+
+    // Runs both passes drew keep their references through the current ones
+    release_commands(list->previous, list->previous_count);
+    list->previous_count = 0;
+}
+
+const SparkDrawCommand* spark_draw_list_get(const SparkDrawList* list, int index) {
+    if (!list || index < 0 || index >= list->count) return NULL;
+    return &list->commands[index];
+}
+
+void spark_draw_list_set(SparkDrawList* list, int index, const SparkDrawCommand* command) {
+    if (!list || !command || index < 0 || index >= list->count) return;
+    if (memcmp(&list->commands[index], command, sizeof(SparkDrawCommand)) == 0) return;
+    if (!ensure_object(list)) return;
+    SPARK_TRACE_INVALIDATION(list->object);
+
+    invalidate_command(list, &list->commands[index]);
+    retain_command(command);
+    release_commands(&list->commands[index], 1);
+    list->commands[index] = *command;
+    invalidate_command(list, command);
+}
+
+void spark_draw_set_target(SparkDrawList* list) {
+    draw.target = list;
+}
+
+SparkDrawList* spark_draw_get_target(void) {
+    if (draw.target) return draw.target;
+    if (!draw.default_list) {
+        draw.default_list = spark_draw_list_new();
+    }
+    return draw.default_list;
+}
+
+// Runs the app's draw callback into the frame list. Its object replays the
+// commands from its draw event into the layer LVGL is rendering, clipped to
+// the dirty area, so a frame that draws the same thing invalidates nothing.
+void spark_draw_frame(void (*callback)(void)) {
+    if (!draw.frame_list) {
+        draw.frame_list = calloc(1, sizeof(SparkDrawList));
+        if (!draw.frame_list) return;
+        draw.frame_list->background = true;
+    }
+
+    SparkDrawList* target = draw.target;
+    draw.target = draw.frame_list;
+    spark_graphics_begin_frame();
+    spark_draw_list_begin(draw.frame_list);
+    callback();
+    spark_draw_list_end(draw.frame_list);
+    draw.target = target;
+}
+
+void spark_draw_shutdown(void) {
+    spark_draw_list_free(draw.default_list);
+    spark_draw_list_free(draw.frame_list);
+    draw.target = NULL;
+}
+
+// Lines and points map exactly and text only moves. Rectangles and ellipses
+// stay plain boxes while the transform keeps them axis-aligned, otherwise
+// they get a rotation; a filled square-cornered rectangle becomes a wide
+// line instead.
+static void transform_command(SparkDrawCommand* command, const SparkTransform* t) {
+    if (command->shape == SPARK_DRAW_TEXT) {
+        float point[2] = { command->x, command->y };
+        spark_transform_apply(t, point, point, 1);
+        command->x = point[0];
+        command->y = point[1];
+        return;
+    }
+
+    if (command->shape == SPARK_DRAW_POINT || command->shape == SPARK_DRAW_LINE) {
+        float points[4] = { command->x, command->y, command->w, command->h };
+        spark_transform_apply(t, points, points, command->shape == SPARK_DRAW_LINE ? 2 : 1);
+        command->x = points[0];
+        command->y = points[1];
+        if (command->shape == SPARK_DRAW_LINE) {
+            command->w = points[2];
+            command->h = points[3];
+            command->radius *= sqrtf(fabsf(t->a * t->d - t->b * t->c));
+        }
+        return;
+    }
+
+    bool scaled = fabsf(t->b) < AXIS_EPSILON && fabsf(t->c) < AXIS_EPSILON;
+    bool quarter_turn = fabsf(t->a) < AXIS_EPSILON && fabsf(t->d) < AXIS_EPSILON;
+    if (scaled || quarter_turn) {
+        float corners[4] = { command->x, command->y, command->x + command->w, command->y + command->h };
+        spark_transform_apply(t, corners, corners, 2);
+        command->x = fminf(corners[0], corners[2]);
+        command->y = fminf(corners[1], corners[3]);
+        command->w = fabsf(corners[2] - corners[0]);
+        command->h = fabsf(corners[3] - corners[1]);
+        command->radius *= fminf(hypotf(t->a, t->b), hypotf(t->c, t->d));
+        return;
+    }
+
+    float scale_x = hypotf(t->a, t->b);
+    float scale_y = fabsf(t->a * t->d - t->b * t->c) / scale_x;
+    float angle = atan2f(t->b, t->a);
+    float center[2] = { command->x + command->w / 2, command->y + command->h / 2 };
+    spark_transform_apply(t, center, center, 1);
+    float w = command->w * scale_x;
+    float h = command->h * scale_y;
+
+    if (command->shape == SPARK_DRAW_RECTANGLE && command->filled && command->radius == 0.0f) {
+        float dx = cosf(angle) * w / 2;
+        float dy = sinf(angle) * w / 2;
+        command->shape = SPARK_DRAW_LINE;
+        command->x = center[0] - dx;
+        command->y = center[1] - dy;
+        command->w = center[0] + dx;
+        command->h = center[1] + dy;
+        command->radius = h;
+        return;
+    }
+
+    int rotation = (int)lroundf(angle * (1800.0f / PI)) % 3600;
+    command->rotation = (int16_t)(rotation < 0 ? rotation + 3600 : rotation);
+    command->x = center[0] - w / 2;
+    command->y = center[1] - h / 2;
+    command->w = w;
+    command->h = h;
+    command->radius *= fminf(scale_x, scale_y);
+}
+
+// Reserves the next command with the current color and blend mode
+static SparkDrawCommand* start_command(SparkDrawList* list, SparkDrawShape shape,
+                                       float x, float y, float w, float h) {
+    if (!list || !reserve(&list->commands, &list->capacity, list->count + 1)) return NULL;
+
+    SparkDrawCommand* command = &list->commands[list->count];
+    memset(command, 0, sizeof(SparkDrawCommand));
+    command->shape = shape;
+    command->opa = spark_graphics_get_opacity();
+    command->color = spark_graphics_get_color();
+    command->blend_mode = spark_graphics_get_blend_mode();
+    command->x = x;
+    command->y = y;
+    command->w = w;
+    command->h = h;
+    return command;
+}
+
+static int finish_command(SparkDrawList* list, SparkDrawCommand* command) {
+    const SparkTransform* transform = spark_graphics_get_transform();
+    if (!spark_transform_is_identity(transform)) transform_command(command, transform);
+
+    // Inside begin/end the diff at end decides what redraws
+    if (!list->building && ensure_object(list)) {
+        SPARK_TRACE_INVALIDATION(list->object);
+        invalidate_command(list, command);
+    }
+    return list->count++;
+}
+
+static int append(SparkDrawShape shape, const char* mode, float x, float y, float w, float h,
+                  float radius) {
+    SparkDrawList* list = spark_draw_get_target();
+    SparkDrawCommand* command = start_command(list, shape, x, y, w, h);
+    if (!command) return -1;
+    command->filled = mode && strcmp(mode, "fill") == 0;
+    command->radius = radius;
+    return finish_command(list, command);
+}
+
+// Unchanged strings reuse their run, so a HUD redrawn every frame allocates nothing
+int spark_draw_text_run(const char* text, const lv_font_t* font, float x, float y, float wrap_width,
+                        lv_text_align_t align, lv_color_t color, lv_opa_t opa) {
+    uint32_t run = spark_text_run_acquire(text, font, wrap_width > 0.0f ? (int32_t)wrap_width : 0, align);
+    if (!run) return -1;
+
+    int32_t w, h;
+    spark_text_run_get(run, NULL, NULL, NULL, &w, &h);
+    SparkDrawList* list = spark_draw_get_target();
+    SparkDrawCommand* command = start_command(list, SPARK_DRAW_TEXT, x, y, (float)w, (float)h);
+    if (!command) {
+        spark_text_run_release(run);
+        return -1;
+    }
+    command->text = run;
+    command->color = color;
+    command->opa = opa;
+    return finish_command(list, command);
+}
+
+int spark_draw_rectangle(const char* mode, float x, float y, float w, float h) {
+    return append(SPARK_DRAW_RECTANGLE, mode, x, y, w, h, 0.0f);
+}
+
+int spark_draw_rounded_rectangle(const char* mode, float x, float y, float w, float h, float radius) {
+    radius = fminf(radius, fminf(w / 2, h / 2));
+    return append(SPARK_DRAW_RECTANGLE, mode, x, y, w, h, radius);
+}
+
+int spark_draw_circle(const char* mode, float x, float y, float radius) {
+    return append(SPARK_DRAW_ELLIPSE, mode, x - radius, y - radius, radius * 2, radius * 2, 0.0f);
+}
+
+int spark_draw_ellipse(const char* mode, float x, float y, float radiusx, float radiusy) {
+    return append(SPARK_DRAW_ELLIPSE, mode, x - radiusx, y - radiusy, radiusx * 2, radiusy * 2, 0.0f);
+}
+
+int spark_draw_point(float x, float y) {
+    return append(SPARK_DRAW_POINT, "fill", x, y, 1.0f, 1.0f, 0.0f);
+}
+
+int spark_draw_line(float x1, float y1, float x2, float y2) {
+    return append(SPARK_DRAW_LINE, "line", x1, y1, x2, y2, 1.0f);
+}
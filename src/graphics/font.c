@@ -0,0 +1,343 @@
+// font.c
+#include "spark_graphics/font.h"
+#include "../internal.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DEFAULT_BUDGET (1024 * 1024)
+#define GLYPH_BUCKETS 1024
+
+// tiny_ttf's own cache only has to hold a glyph until it is copied here
+#define TTF_CACHE_GLYPHS 4
+
+// One per file, shared by every size loaded from it
+typedef struct FontFace {
+    char* path;
+    void* data;
+    size_t size;
+    bool mapped;            // munmap rather than free
+    int refs;
+    struct FontFace* next;
+} FontFace;
+
+struct SparkFont {
+    lv_font_t font;         // What LVGL draws with, its bitmaps come from the cache
+    lv_font_t* ttf;
+    FontFace* face;
+    int size;
+};
+
+typedef struct Glyph {
+    const SparkFont* font;
+    uint32_t index;
+    lv_draw_buf_t* bitmap;
+    size_t bytes;
+    int pins;               // Being drawn, can't be evicted
+    struct Glyph* newer;
+    struct Glyph* older;
+    struct Glyph* chain;
+} Glyph;
+
+static struct {
+    FontFace* faces;
+    SparkFont* current;
+
+    // Draw units may ask for bitmaps from several threads
+    pthread_mutex_t mutex;
+    Glyph* buckets[GLYPH_BUCKETS];
+    Glyph* newest;
+    Glyph* oldest;
+    size_t budget;
+    size_t bytes;
+    int glyphs;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+} fonts = { .mutex = PTHREAD_MUTEX_INITIALIZER, .budget = DEFAULT_BUDGET };
+
+static FontFace* open_face(const char* path) {
+    for (FontFace* face = fonts.faces; face; face = face->next) {
+        if (strcmp(face->path, path) == 0) {
+            face->refs++;
+            return face;
+        }
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    bool mapped = data != MAP_FAILED;
+    if (!mapped) {
+        // Filesystems without mmap, such as the web build's, read it instead
+        data = malloc(size);
+        if (data && read(fd, data, size) != (ssize_t)size) {
+            free(data);
+            data = NULL;
+        }
+    }
+    close(fd);
+    if (!data) return NULL;
+
+    FontFace* face = calloc(1, sizeof(FontFace));
+    char* copy = strdup(path);
+    if (!face || !copy) {
+        if (mapped) munmap(data, size); else free(data);
+        free(face);
+        free(copy);
+        return NULL;
+    }
+    face->path = copy;
+    face->data = data;
+    face->size = size;
+    face->mapped = mapped;
+    face->refs = 1;
+    face->next = fonts.faces;
+    fonts.faces = face;
+    return face;
+}
+
+static void close_face(FontFace* face) {
+    if (--face->refs > 0) return;
+
+    FontFace** link = &fonts.faces;
+    while (*link != face) link = &(*link)->next;
+    *link = face->next;
+
+    if (face->mapped) munmap(face->data, face->size); else free(face->data);
+    free(face->path);
+    free(face);
+}
+
+// Glyph cache, callers hold the mutex
+
+static Glyph** bucket_of(const SparkFont* font, uint32_t index) {
+    uint32_t hash = (uint32_t)((uintptr_t)font >> 4) ^ index * 2654435761u;
+    return &fonts.buckets[hash % GLYPH_BUCKETS];
+}
+
+static void unlink_lru(Glyph* glyph) {
+    if (glyph->newer) glyph->newer->older = glyph->older; else fonts.newest = glyph->older;
+    if (glyph->older) glyph->older->newer = glyph->newer; else fonts.oldest = glyph->newer;
+    glyph->newer = glyph->older = NULL;
+}
+
+static void push_newest(Glyph* glyph) {
+    glyph->older = fonts.newest;
+    glyph->newer = NULL;
+    if (fonts.newest) fonts.newest->newer = glyph; else fonts.oldest = glyph;
+    fonts.newest = glyph;
+}
+
+static Glyph* find_glyph(const SparkFont* font, uint32_t index) {
+    for (Glyph* glyph = *bucket_of(font, index); glyph; glyph = glyph->chain) {
+        if (glyph->font == font && glyph->index == index) return glyph;
+    }
+    return NULL;
+}
+
+static void remove_glyph(Glyph* glyph) {
+    Glyph** link = bucket_of(glyph->font, glyph->index);
+    while (*link != glyph) link = &(*link)->chain;
+    *link = glyph->chain;
+
+    unlink_lru(glyph);
+    fonts.bytes -= glyph->bytes;
+    fonts.glyphs--;
+    lv_draw_buf_destroy(glyph->bitmap);
+    free(glyph);
+}
+
+static void evict_to_budget(void) {
+    Glyph* glyph = fonts.oldest;
+    while (glyph && fonts.bytes > fonts.budget) {
+        Glyph* newer = glyph->newer;
+        if (glyph->pins == 0) {
+            remove_glyph(glyph);
+            fonts.evictions++;
+        }
+        glyph = newer;
+    }
+}
+
+// tiny_ttf rasterizes into its own cache entry, which is copied and released
+static Glyph* rasterize(const SparkFont* font, lv_font_glyph_dsc_t* dsc, lv_draw_buf_t* draw_buf) {
+    const lv_font_t* wrapper = dsc->resolved_font;
+    dsc->resolved_font = font->ttf;
+    const lv_draw_buf_t* source = font->ttf->get_glyph_bitmap(dsc, draw_buf);
+    lv_draw_buf_t* bitmap = source ? lv_draw_buf_dup(source) : NULL;
+    if (font->ttf->release_glyph) font->ttf->release_glyph(font->ttf, dsc);
+    dsc->resolved_font = wrapper;
+    if (!bitmap) return NULL;
+
+    Glyph* glyph = calloc(1, sizeof(Glyph));
+    if (!glyph) {
+        lv_draw_buf_destroy(bitmap);
+        return NULL;
+    }
+    glyph->font = font;
+    glyph->index = dsc->gid.index;
+    glyph->bitmap = bitmap;
+    glyph->bytes = bitmap->data_size + sizeof(Glyph);
+
+    Glyph** bucket = bucket_of(font, glyph->index);
+    glyph->chain = *bucket;
+    *bucket = glyph;
+    push_newest(glyph);
+    fonts.bytes += glyph->bytes;
+    fonts.glyphs++;
+    return glyph;
+}
+
+// LVGL font callbacks
+
+static bool get_glyph_dsc(const lv_font_t* lv_font, lv_font_glyph_dsc_t* dsc, uint32_t letter,
+                          uint32_t letter_next) {
+    const SparkFont* font = lv_font->user_data;
+    return font->ttf->get_glyph_dsc(font->ttf, dsc, letter, letter_next);
+}
+
+static const void* get_glyph_bitmap(lv_font_glyph_dsc_t* dsc, lv_draw_buf_t* draw_buf) {
+    const SparkFont* font = dsc->resolved_font->user_data;
+
+    pthread_mutex_lock(&fonts.mutex);
+    Glyph* glyph = find_glyph(font, dsc->gid.index);
+    if (glyph) {
+        fonts.hits++;
+        unlink_lru(glyph);
+        push_newest(glyph);
+    } else {
+        fonts.misses++;
+        glyph = rasterize(font, dsc, draw_buf);
+    }
+    if (glyph) {
+        glyph->pins++;
+        evict_to_budget();
+    }
+    pthread_mutex_unlock(&fonts.mutex);
+
+    // The entry slot belongs to the font, release_glyph gets it back
+    dsc->entry = (lv_cache_entry_t*)glyph;
+    return glyph ? glyph->bitmap : NULL;
+}
+
+static void release_glyph(const lv_font_t* lv_font, lv_font_glyph_dsc_t* dsc) {
+    Glyph* glyph = (Glyph*)dsc->entry;
+    if (!glyph) return;
+
+    pthread_mutex_lock(&fonts.mutex);
+    glyph->pins--;
+    evict_to_budget();
+    pthread_mutex_unlock(&fonts.mutex);
+    dsc->entry = NULL;
+}
+
+SparkFont* spark_graphics_new_font(const char* path, int size) {
+    if (!path || size <= 0) return NULL;
+
+    FontFace* face = open_face(path);
+    if (!face) {
+        fprintf(stderr, "Failed to load font %s\n", path);
+        return NULL;
+    }
+
+    SparkFont* font = calloc(1, sizeof(SparkFont));
+    lv_font_t* ttf = font ? lv_tiny_ttf_create_data_ex(face->data, face->size, size,
+                                                       LV_FONT_KERNING_NORMAL, TTF_CACHE_GLYPHS) : NULL;
+    if (!ttf) {
+        fprintf(stderr, "Failed to parse font %s\n", path);
+        free(font);
+        close_face(face);
+        return NULL;
+    }
+
+    font->ttf = ttf;
+    font->face = face;
+    font->size = size;
+
+    // Same metrics, bitmaps routed through the cache
+    font->font = *ttf;
+    font->font.get_glyph_dsc = get_glyph_dsc;
+    font->font.get_glyph_bitmap = get_glyph_bitmap;
+    font->font.release_glyph = release_glyph;
+    font->font.user_data = font;
+    return font;
+}
+
+void spark_graphics_font_free(SparkFont* font) {
+    if (!font) return;
+    if (fonts.current == font) fonts.current = NULL;
+    spark_text_forget_font(&font->font);
+
+    pthread_mutex_lock(&fonts.mutex);
+    Glyph* glyph = fonts.oldest;
+    while (glyph) {
+        Glyph* newer = glyph->newer;
+        if (glyph->font == font) remove_glyph(glyph);
+        glyph = newer;
+    }
+    pthread_mutex_unlock(&fonts.mutex);
+
+    lv_tiny_ttf_destroy(font->ttf);
+    close_face(font->face);
+    free(font);
+}
+
+const lv_font_t* spark_graphics_font_get_lv_font(const SparkFont* font) {
+    return font ? &font->font : NULL;
+}
+
+int spark_graphics_font_get_size(const SparkFont* font) {
+    return font ? font->size : 0;
+}
+
+void spark_graphics_set_font(SparkFont* font) {
+    fonts.current = font;
+}
+
+SparkFont* spark_graphics_get_font(void) {
+    return fonts.current;
+}
+
+const lv_font_t* spark_font_get_current(void) {
+    return fonts.current ? &fonts.current->font : LV_FONT_DEFAULT;
+}
+
+void spark_graphics_set_glyph_cache_budget(size_t bytes) {
+    pthread_mutex_lock(&fonts.mutex);
+    fonts.budget = bytes;
+    evict_to_budget();
+    pthread_mutex_unlock(&fonts.mutex);
+}
+
+void spark_graphics_get_glyph_cache_stats(SparkGlyphCacheStats* stats) {
+    if (!stats) return;
+    pthread_mutex_lock(&fonts.mutex);
+    stats->hits = fonts.hits;
+    stats->misses = fonts.misses;
+    stats->evictions = fonts.evictions;
+    stats->bytes = fonts.bytes;
+    stats->budget = fonts.budget;
+    stats->glyphs = fonts.glyphs;
+    pthread_mutex_unlock(&fonts.mutex);
+}
+
+void spark_graphics_reset_glyph_cache_stats(void) {
+    pthread_mutex_lock(&fonts.mutex);
+    fonts.hits = 0;
+    fonts.misses = 0;
+    fonts.evictions = 0;
+    pthread_mutex_unlock(&fonts.mutex);
+}
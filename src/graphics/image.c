@@ -5,6 +5,7 @@
 #include <string.h>
 #include "spark_graphics/image.h"
 #include "spark_graphics/layer.h"
+#include "../internal.h"
 
 static lv_obj_t* current_parent = NULL;
 
@@ -169,3 +170,53 @@ float spark_graphics_image_get_width(SparkImage* image) {
     return image ? (float)image->width : 0;
 }
 
+// Decodes an LVGL image source to tightly packed 0xAARRGGBB pixels, which
+// the caller frees
+uint32_t* spark_image_decode_argb8888(const void* src, int32_t* width, int32_t* height) {
+    lv_image_decoder_dsc_t dsc;
+    if (lv_image_decoder_open(&dsc, src, NULL) != LV_RESULT_OK) return NULL;
+
+    const lv_draw_buf_t* decoded = dsc.decoded;
+    if (!decoded) {
+        lv_image_decoder_close(&dsc);
+        return NULL;
+    }
+
+    int32_t w = decoded->header.w;
+    int32_t h = decoded->header.h;
+    uint32_t stride = decoded->header.stride;
+    uint32_t cf = decoded->header.cf;
+    uint32_t* pixels = malloc((size_t)w * h * 4);
+
+    for (int32_t y = 0; pixels && y < h; y++) {
+        const uint8_t* row = decoded->data + (size_t)y * stride;
+        uint32_t* out = pixels + (size_t)y * w;
+        switch (cf) {
+            case LV_COLOR_FORMAT_ARGB8888:
+                memcpy(out, row, (size_t)w * 4);
+                break;
+            case LV_COLOR_FORMAT_XRGB8888:
+                memcpy(out, row, (size_t)w * 4);
+                for (int32_t x = 0; x < w; x++) out[x] |= 0xFF000000u;
+                break;
+            case LV_COLOR_FORMAT_RGB888:
+                for (int32_t x = 0; x < w; x++) {
+                    out[x] = 0xFF000000u | (uint32_t)row[x * 3 + 2] << 16 |
+                             (uint32_t)row[x * 3 + 1] << 8 | row[x * 3];
+                }
+                break;
+            default:
+                fprintf(stderr, "Unsupported decoded image format %u\n", (unsigned)cf);
+                free(pixels);
+                pixels = NULL;
+                break;
+        }
+    }
+    lv_image_decoder_close(&dsc);
+
+    if (pixels) {
+        *width = w;
+        *height = h;
+    }
+    return pixels;
+}
@@ -0,0 +1,67 @@
+// image_object.c
+#include "spark_graphics/layer.h"
+#include "../internal.h"
+
+static void draw_event_cb(lv_event_t* e) {
+    SparkImageObject* view = lv_event_get_user_data(e);
+    lv_layer_t* layer = lv_event_get_layer(e);
+
+    // Draw events fire per dirty area, bring the pixels up to date and drop
+    // the cached image once per change
+    if (view->changed) {
+        if (view->prepare) view->prepare(view->owner);
+        lv_image_cache_drop(&view->image);
+        view->changed = false;
+    }
+
+    lv_area_t coords;
+    lv_obj_get_coords(view->object, &coords);
+
+    lv_draw_image_dsc_t dsc;
+    lv_draw_image_dsc_init(&dsc);
+    dsc.src = &view->image;
+    lv_draw_image(layer, &dsc, &coords);
+}
+
+static void delete_event_cb(lv_event_t* e) {
+    SparkImageObject* view = lv_event_get_user_data(e);
+    view->object = NULL;
+}
+
+bool spark_image_object_create(SparkImageObject* view, float x, float y,
+                               void (*prepare)(void* owner), void* owner) {
+    view->prepare = prepare;
+    view->owner = owner;
+    view->object = lv_obj_create(spark_graphics_get_current_layer());
+    if (!view->object) return false;
+
+    lv_obj_remove_style_all(view->object);
+    lv_obj_remove_flag(view->object, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_pos(view->object, (int32_t)x, (int32_t)y);
+    lv_obj_add_event_cb(view->object, draw_event_cb, LV_EVENT_DRAW_MAIN, view);
+    lv_obj_add_event_cb(view->object, delete_event_cb, LV_EVENT_DELETE, view);
+    return true;
+}
+
+void spark_image_object_set_pixels(SparkImageObject* view, const uint32_t* pixels, int32_t w, int32_t h,
+                                   int32_t stride) {
+    view->image.header.magic = LV_IMAGE_HEADER_MAGIC;
+    view->image.header.cf = LV_COLOR_FORMAT_ARGB8888;
+    view->image.header.w = w;
+    view->image.header.h = h;
+    view->image.header.stride = (uint32_t)stride * 4;
+    view->image.data = (const uint8_t*)pixels;
+    view->image.data_size = (uint32_t)((size_t)stride * h * 4);
+    view->changed = true;
+    if (view->object) lv_obj_set_size(view->object, w, h);
+}
+
+void spark_image_object_changed(SparkImageObject* view) {
+    view->changed = true;
+    if (view->object) lv_obj_invalidate(view->object);
+}
+
+void spark_image_object_free(SparkImageObject* view) {
+    if (view->object) lv_obj_delete(view->object);
+    lv_image_cache_drop(&view->image);
+}
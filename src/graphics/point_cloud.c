@@ -0,0 +1,201 @@
+// point_cloud.c
+#include "spark_graphics/point_cloud.h"
+#include "spark_graphics/color.h"
+#include "spark_graphics/layer.h"
+#include "../internal.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+struct SparkPointCloud {
+    SparkImageObject view;  // Plotted when it changed, before it draws
+    float x;                // Region origin, subtracted from every point
+    float y;
+    int32_t width;
+    int32_t height;
+
+    const float* xy;        // Borrowed, or points at owned_xy
+    int count;
+    float* owned_xy;
+    size_t owned_capacity;
+
+    const uint32_t* colors;
+    const float* sizes;
+    uint32_t color;         // 0xAARRGGBB
+    float point_size;
+
+    uint32_t* pixels;
+};
+
+static void plot(SparkPointCloud* cloud, int index, int32_t px, int32_t py) {
+    uint32_t color = cloud->colors ? cloud->colors[index] : cloud->color;
+    // NaN or huge sizes would overflow the conversion and the square's corners
+    float requested = cloud->sizes ? cloud->sizes[index] : cloud->point_size;
+    float largest = (float)(cloud->width > cloud->height ? cloud->width : cloud->height);
+    int32_t size = (int32_t)(fminf(fmaxf(requested, 1.0f), largest) + 0.5f);
+
+    if (size <= 1) {
+        cloud->pixels[py * cloud->width + px] = color;
+        return;
+    }
+
+    // Square centered on the point, clipped to the region
+    int32_t x1 = px - (size - 1) / 2;
+    int32_t y1 = py - (size - 1) / 2;
+    int32_t x2 = x1 + size - 1;
+    int32_t y2 = y1 + size - 1;
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= cloud->width) x2 = cloud->width - 1;
+    if (y2 >= cloud->height) y2 = cloud->height - 1;
+
+    for (int32_t y = y1; y <= y2; y++) {
+        uint32_t* row = cloud->pixels + y * cloud->width;
+        for (int32_t x = x1; x <= x2; x++) {
+            row[x] = color;
+        }
+    }
+}
+
+static void plot_all(void* owner) {
+    SparkPointCloud* cloud = owner;
+    memset(cloud->pixels, 0, (size_t)cloud->width * cloud->height * 4);
+
+    const float* xy = cloud->xy;
+    int i = 0;
+
+#if defined(__SSE2__)
+    // Four points per step: offset, bounds test and truncate in registers,
+    // only the points inside the region are plotted
+    const __m128 origin_x = _mm_set1_ps(cloud->x);
+    const __m128 origin_y = _mm_set1_ps(cloud->y);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 width = _mm_set1_ps((float)cloud->width);
+    const __m128 height = _mm_set1_ps((float)cloud->height);
+
+    for (; i + 4 <= cloud->count; i += 4) {
+        __m128 a = _mm_loadu_ps(xy + i * 2);
+        __m128 b = _mm_loadu_ps(xy + i * 2 + 4);
+        __m128 xs = _mm_sub_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), origin_x);
+        __m128 ys = _mm_sub_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)), origin_y);
+
+        __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(xs, zero), _mm_cmplt_ps(xs, width)),
+                                   _mm_and_ps(_mm_cmpge_ps(ys, zero), _mm_cmplt_ps(ys, height)));
+        int mask = _mm_movemask_ps(inside);
+        if (!mask) continue;
+
+        int32_t px[4], py[4];
+        _mm_storeu_si128((__m128i*)px, _mm_cvttps_epi32(xs));
+        _mm_storeu_si128((__m128i*)py, _mm_cvttps_epi32(ys));
+        for (int lane = 0; lane < 4; lane++) {
+            if (mask & (1 << lane)) plot(cloud, i + lane, px[lane], py[lane]);
+        }
+    }
+#endif
+
+    for (; i < cloud->count; i++) {
+        float x = xy[i * 2] - cloud->x;
+        float y = xy[i * 2 + 1] - cloud->y;
+        // Written so NaN fails it, as in the SIMD path
+        if (!(x >= 0.0f && x < (float)cloud->width && y >= 0.0f && y < (float)cloud->height)) continue;
+        plot(cloud, i, (int32_t)x, (int32_t)y);
+    }
+}
+
+SparkPointCloud* spark_graphics_point_cloud_new(float x, float y, float w, float h) {
+    if (w < 1.0f || h < 1.0f) return NULL;
+
+    SparkPointCloud* cloud = calloc(1, sizeof(SparkPointCloud));
+    if (!cloud) return NULL;
+
+    cloud->x = x;
+    cloud->y = y;
+    cloud->width = (int32_t)w;
+    cloud->height = (int32_t)h;
+    cloud->point_size = 1.0f;
+
+    lv_color_t color = spark_graphics_get_color();
+    cloud->color = (uint32_t)spark_graphics_get_opacity() << 24 |
+                   (uint32_t)color.red << 16 | (uint32_t)color.green << 8 | color.blue;
+
+    cloud->pixels = calloc((size_t)cloud->width * cloud->height, 4);
+    bool created = spark_image_object_create(&cloud->view, x, y, plot_all, cloud);
+    if (!cloud->pixels || !created) {
+        spark_image_object_free(&cloud->view);
+        free(cloud->pixels);
+        free(cloud);
+        return NULL;
+    }
+
+    spark_image_object_set_pixels(&cloud->view, cloud->pixels, cloud->width, cloud->height, cloud->width);
+    return cloud;
+}
+
+void spark_graphics_point_cloud_free(SparkPointCloud* cloud) {
+    if (!cloud) return;
+    spark_image_object_free(&cloud->view);
+    free(cloud->owned_xy);
+    free(cloud->pixels);
+    free(cloud);
+}
+
+lv_obj_t* spark_graphics_point_cloud_get_object(SparkPointCloud* cloud) {
+    return cloud ? cloud->view.object : NULL;
+}
+
+static void mark_dirty(SparkPointCloud* cloud) {
+    spark_image_object_changed(&cloud->view);
+}
+
+void spark_graphics_update_point_cloud(SparkPointCloud* cloud, const float* xy, int count, bool copy) {
+    if (!cloud) return;
+    SPARK_TRACE_INVALIDATION(cloud->view.object);
+
+    if (!xy || count <= 0) {
+        cloud->xy = NULL;
+        cloud->count = 0;
+        mark_dirty(cloud);
+        return;
+    }
+
+    if (copy) {
+        size_t bytes = sizeof(float) * 2 * (size_t)count;
+        if (bytes > cloud->owned_capacity) {
+            float* grown = realloc(cloud->owned_xy, bytes);
+            if (!grown) return;
+            cloud->owned_xy = grown;
+            cloud->owned_capacity = bytes;
+        }
+        memcpy(cloud->owned_xy, xy, bytes);
+        xy = cloud->owned_xy;
+    }
+
+    cloud->xy = xy;
+    cloud->count = count;
+    mark_dirty(cloud);
+}
+
+void spark_graphics_point_cloud_set_colors(SparkPointCloud* cloud, const uint32_t* colors) {
+    if (!cloud) return;
+    SPARK_TRACE_INVALIDATION(cloud->view.object);
+    cloud->colors = colors;
+    mark_dirty(cloud);
+}
+
+void spark_graphics_point_cloud_set_sizes(SparkPointCloud* cloud, const float* sizes) {
+    if (!cloud) return;
+    SPARK_TRACE_INVALIDATION(cloud->view.object);
+    cloud->sizes = sizes;
+    mark_dirty(cloud);
+}
+
+void spark_graphics_point_cloud_set_point_size(SparkPointCloud* cloud, float size) {
+    if (!cloud) return;
+    SPARK_TRACE_INVALIDATION(cloud->view.object);
+    cloud->point_size = size;
+    mark_dirty(cloud);
+}
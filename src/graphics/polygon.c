@@ -0,0 +1,312 @@
+// polygon.c
+#include "spark_graphics/primitives.h"
+#include "spark_graphics/color.h"
+#include "../internal.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Filled polygons are scanline rasterized into an A8 coverage mask with
+// exact-area anti-aliasing and the non-zero rule, so concave and
+// self-intersecting outlines fill correctly and shared edges have no seams.
+// LVGL draws the mask as one recolored image.
+typedef struct {
+    float* vertices;        // Parent-relative x, y pairs as last passed in
+    int count;
+    size_t capacity;
+    lv_color_t color;
+    lv_opa_t opa;
+    int32_t x;              // Parent-relative top-left of the object
+    int32_t y;
+
+    lv_image_dsc_t mask;
+    uint8_t* mask_data;
+    size_t mask_capacity;
+    float* coverage;        // Signed area deltas, w * h + 2
+    size_t coverage_capacity;
+} SparkPolygon;
+
+static bool grow(void** buffer, size_t* capacity, size_t needed) {
+    if (needed <= *capacity) return true;
+    void* grown = realloc(*buffer, needed);
+    if (!grown) return false;
+    *buffer = grown;
+    *capacity = needed;
+    return true;
+}
+
+// Adds one edge's signed coverage to the accumulation buffer. Coordinates
+// are relative to the mask, x in [0, w], and a row's overflow lands at the
+// start of the next row, which the running sum carries correctly.
+static void accumulate_edge(float* coverage, int w, int h, float x0, float y0, float x1, float y1) {
+    if (y0 == y1) return;
+
+    float dir = 1.0f;
+    if (y0 > y1) {
+        float t;
+        t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+        dir = -1.0f;
+    }
+
+    float dxdy = (x1 - x0) / (y1 - y0);
+    float x = x0;
+    int y_start = y0 > 0.0f ? (int)y0 : 0;
+    if (y0 < 0.0f) x -= y0 * dxdy;
+    int y_end = (int)ceilf(y1);
+    if (y_end > h) y_end = h;
+
+    for (int y = y_start; y < y_end; y++) {
+        float* row = coverage + (size_t)y * w;
+        float dy = fminf((float)(y + 1), y1) - fmaxf((float)y, y0);
+        float x_next = x + dxdy * dy;
+        float d = dy * dir;
+
+        float left = x < x_next ? x : x_next;
+        float right = x < x_next ? x_next : x;
+        float left_floor = floorf(left);
+        int left_i = (int)left_floor;
+        int right_i = (int)ceilf(right);
+
+        if (right_i <= left_i + 1) {
+            // Edge stays within one pixel column
+            float mid = 0.5f * (x + x_next) - left_floor;
+            row[left_i] += d - d * mid;
+            row[left_i + 1] += d * mid;
+        } else {
+            float s = 1.0f / (right - left);
+            float left_frac = left - left_floor;
+            float a0 = 0.5f * s * (1.0f - left_frac) * (1.0f - left_frac);
+            float right_frac = right - (float)right_i + 1.0f;
+            float am = 0.5f * s * right_frac * right_frac;
+
+            row[left_i] += d * a0;
+            if (right_i == left_i + 2) {
+                row[left_i + 1] += d * (1.0f - a0 - am);
+            } else {
+                float a1 = s * (1.5f - left_frac);
+                row[left_i + 1] += d * (a1 - a0);
+                for (int xi = left_i + 2; xi < right_i - 1; xi++) {
+                    row[xi] += d * s;
+                }
+                float a2 = a1 + (float)(right_i - left_i - 3) * s;
+                row[right_i - 1] += d * (1.0f - a2 - am);
+            }
+            row[right_i] += d * am;
+        }
+        x = x_next;
+    }
+}
+
+// Running sum of the deltas into 8-bit coverage, returns the carried sum
+static float fill_span(const float* coverage, uint8_t* out, int count, float sum) {
+    int i = 0;
+
+#if defined(__SSE2__)
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    __m128 carry = _mm_set1_ps(sum);
+
+    for (; i + 4 <= count; i += 4) {
+        // In-register prefix sum of four deltas
+        __m128 x = _mm_loadu_ps(coverage + i);
+        x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)));
+        x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)));
+        x = _mm_add_ps(x, carry);
+
+        __m128 y = _mm_mul_ps(_mm_min_ps(_mm_and_ps(x, abs_mask), one), scale);
+        __m128i bytes = _mm_cvtps_epi32(y);
+        bytes = _mm_packs_epi32(bytes, bytes);
+        bytes = _mm_packus_epi16(bytes, bytes);
+        int packed = _mm_cvtsi128_si32(bytes);
+        memcpy(out + i, &packed, 4);
+
+        carry = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    sum = _mm_cvtss_f32(carry);
+#endif
+
+    for (; i < count; i++) {
+        sum += coverage[i];
+        float y = fminf(fabsf(sum), 1.0f);
+        out[i] = (uint8_t)(y * 255.0f + 0.5f);
+    }
+    return sum;
+}
+
+static bool rasterize(SparkPolygon* poly, int32_t w, int32_t h) {
+    uint32_t stride = lv_draw_buf_width_to_stride(w, LV_COLOR_FORMAT_A8);
+    size_t mask_size = (size_t)stride * h;
+    size_t cells = (size_t)w * h + 2;
+
+    // Buffers only grow, so reshaping a polygon every frame doesn't allocate
+    if (!grow((void**)&poly->mask_data, &poly->mask_capacity, mask_size) ||
+        !grow((void**)&poly->coverage, &poly->coverage_capacity, cells * sizeof(float))) {
+        return false;
+    }
+    memset(poly->coverage, 0, cells * sizeof(float));
+
+    for (int i = 0; i < poly->count; i++) {
+        int j = (i + 1) % poly->count;
+        accumulate_edge(poly->coverage, w, h,
+                        poly->vertices[i * 2] - poly->x, poly->vertices[i * 2 + 1] - poly->y,
+                        poly->vertices[j * 2] - poly->x, poly->vertices[j * 2 + 1] - poly->y);
+    }
+
+    float sum = 0.0f;
+    for (int32_t y = 0; y < h; y++) {
+        sum = fill_span(poly->coverage + (size_t)y * w, poly->mask_data + (size_t)y * stride, w, sum);
+    }
+
+    // LVGL caches decoded images and headers by source pointer
+    lv_image_cache_drop(&poly->mask);
+    lv_image_header_cache_drop(&poly->mask);
+
+    poly->mask.header.magic = LV_IMAGE_HEADER_MAGIC;
+    poly->mask.header.cf = LV_COLOR_FORMAT_A8;
+    poly->mask.header.w = w;
+    poly->mask.header.h = h;
+    poly->mask.header.stride = stride;
+    poly->mask.data = poly->mask_data;
+    poly->mask.data_size = (uint32_t)mask_size;
+    return true;
+}
+
+static void rebuild(lv_obj_t* obj, SparkPolygon* poly) {
+    float min_x = poly->vertices[0], max_x = poly->vertices[0];
+    float min_y = poly->vertices[1], max_y = poly->vertices[1];
+    for (int i = 1; i < poly->count; i++) {
+        min_x = fminf(min_x, poly->vertices[i * 2]);
+        max_x = fmaxf(max_x, poly->vertices[i * 2]);
+        min_y = fminf(min_y, poly->vertices[i * 2 + 1]);
+        max_y = fmaxf(max_y, poly->vertices[i * 2 + 1]);
+    }
+
+    poly->x = (int32_t)floorf(min_x);
+    poly->y = (int32_t)floorf(min_y);
+    int32_t w = (int32_t)ceilf(max_x) - poly->x;
+    int32_t h = (int32_t)ceilf(max_y) - poly->y;
+    if (w < 1) w = 1;
+    if (h < 1) h = 1;
+
+    if (!rasterize(poly, w, h)) {
+        poly->mask.data = NULL;
+    }
+
+    lv_obj_set_pos(obj, poly->x, poly->y);
+    lv_obj_set_size(obj, w, h);
+    // The shape may change inside an unchanged box
+    lv_obj_invalidate(obj);
+}
+
+static bool set_vertices(SparkPolygon* poly, const float* vertices, int count) {
+    if (!grow((void**)&poly->vertices, &poly->capacity, sizeof(float) * 2 * count)) return false;
+    memcpy(poly->vertices, vertices, sizeof(float) * 2 * count);
+    poly->count = count;
+    return true;
+}
+
+// Whole-pixel moves keep the mask, the object just moves
+static bool is_pixel_translation(const SparkPolygon* poly, const float* vertices, int count,
+                                 int32_t* dx, int32_t* dy) {
+    if (count != poly->count) return false;
+
+    float fx = vertices[0] - poly->vertices[0];
+    float fy = vertices[1] - poly->vertices[1];
+    if (fx != roundf(fx) || fy != roundf(fy)) return false;
+
+    for (int i = 1; i < count; i++) {
+        if (vertices[i * 2] - poly->vertices[i * 2] != fx ||
+            vertices[i * 2 + 1] - poly->vertices[i * 2 + 1] != fy) {
+            return false;
+        }
+    }
+    *dx = (int32_t)fx;
+    *dy = (int32_t)fy;
+    return true;
+}
+
+static void draw_event_cb(lv_event_t* e) {
+    lv_obj_t* obj = lv_event_get_current_target(e);
+    SparkPolygon* poly = lv_event_get_user_data(e);
+    lv_layer_t* layer = lv_event_get_layer(e);
+
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+
+    if (!poly->mask.data) return;
+
+    lv_draw_image_dsc_t dsc;
+    lv_draw_image_dsc_init(&dsc);
+    dsc.src = &poly->mask;
+    dsc.recolor = poly->color;
+    dsc.recolor_opa = LV_OPA_COVER;
+    dsc.opa = poly->opa;
+
+    lv_area_t area = coords;
+    area.x2 = area.x1 + poly->mask.header.w - 1;
+    area.y2 = area.y1 + poly->mask.header.h - 1;
+    lv_draw_image(layer, &dsc, &area);
+}
+
+static void delete_event_cb(lv_event_t* e) {
+    SparkPolygon* poly = lv_event_get_user_data(e);
+    if (poly->mask.data) {
+        lv_image_cache_drop(&poly->mask);
+        lv_image_header_cache_drop(&poly->mask);
+    }
+    free(poly->vertices);
+    free(poly->mask_data);
+    free(poly->coverage);
+    free(poly);
+}
+
+lv_obj_t* spark_polygon_create(lv_obj_t* parent, const float* vertices, int count) {
+    SparkPolygon* poly = calloc(1, sizeof(SparkPolygon));
+    if (!poly) return NULL;
+
+    if (!set_vertices(poly, vertices, count)) {
+        free(poly);
+        return NULL;
+    }
+    poly->color = spark_graphics_get_color();
+    poly->opa = spark_graphics_get_opacity();
+
+    lv_obj_t* obj = lv_obj_create(parent);
+    if (!obj) {
+        free(poly->vertices);
+        free(poly);
+        return NULL;
+    }
+    lv_obj_remove_style_all(obj);
+    lv_obj_remove_flag(obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_user_data(obj, poly);
+    lv_obj_add_event_cb(obj, draw_event_cb, LV_EVENT_DRAW_MAIN, poly);
+    lv_obj_add_event_cb(obj, delete_event_cb, LV_EVENT_DELETE, poly);
+
+    rebuild(obj, poly);
+    return obj;
+}
+
+void spark_polygon_update(lv_obj_t* obj, const float* vertices, int count) {
+    SparkPolygon* poly = lv_obj_get_user_data(obj);
+    if (!poly || !vertices || count < 3) return;
+
+    int32_t dx, dy;
+    if (is_pixel_translation(poly, vertices, count, &dx, &dy)) {
+        if (dx == 0 && dy == 0) return;
+        memcpy(poly->vertices, vertices, sizeof(float) * 2 * count);
+        poly->x += dx;
+        poly->y += dy;
+        lv_obj_set_pos(obj, poly->x, poly->y);
+        return;
+    }
+
+    if (!set_vertices(poly, vertices, count)) return;
+    rebuild(obj, poly);
+}
@@ -0,0 +1,167 @@
+// polyline.c
+#include "spark_graphics/primitives.h"
+#include "spark_graphics/color.h"
+#include "../internal.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A strip of joined segments drawn by one object from its own copy of the
+// vertices, so updates rewrite the buffer in place and only the area the
+// strip covered before and after redraws.
+typedef struct {
+    float* vertices;        // Parent-relative x, y pairs
+    int count;
+    size_t capacity;
+    bool closed;
+    int32_t width;
+    lv_color_t color;
+    lv_opa_t opa;
+    int32_t x;              // Parent-relative top-left of the object
+    int32_t y;
+} SparkPolyline;
+
+// Room around the vertices for half the stroke and its anti-aliasing
+static int32_t stroke_pad(const SparkPolyline* line) {
+    return line->width / 2 + 1;
+}
+
+static void place(lv_obj_t* obj, SparkPolyline* line) {
+    float min_x = line->vertices[0], max_x = line->vertices[0];
+    float min_y = line->vertices[1], max_y = line->vertices[1];
+    for (int i = 1; i < line->count; i++) {
+        min_x = fminf(min_x, line->vertices[i * 2]);
+        max_x = fmaxf(max_x, line->vertices[i * 2]);
+        min_y = fminf(min_y, line->vertices[i * 2 + 1]);
+        max_y = fmaxf(max_y, line->vertices[i * 2 + 1]);
+    }
+
+    int32_t pad = stroke_pad(line);
+    int32_t x = (int32_t)floorf(min_x) - pad;
+    int32_t y = (int32_t)floorf(min_y) - pad;
+    int32_t w = (int32_t)ceilf(max_x) + pad - x + 1;
+    int32_t h = (int32_t)ceilf(max_y) + pad - y + 1;
+
+    // Moving or resizing invalidates the old and new bounds, which LVGL
+    // joins when they overlap. An unchanged box still needs a redraw.
+    if (x == line->x && y == line->y && w == lv_obj_get_width(obj) && h == lv_obj_get_height(obj)) {
+        lv_obj_invalidate(obj);
+        return;
+    }
+    line->x = x;
+    line->y = y;
+    lv_obj_set_pos(obj, x, y);
+    lv_obj_set_size(obj, w, h);
+}
+
+static void draw_event_cb(lv_event_t* e) {
+    lv_obj_t* obj = lv_event_get_current_target(e);
+    SparkPolyline* line = lv_event_get_user_data(e);
+    lv_layer_t* layer = lv_event_get_layer(e);
+
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+    float offset_x = (float)(coords.x1 - line->x);
+    float offset_y = (float)(coords.y1 - line->y);
+    int32_t pad = stroke_pad(line);
+
+    lv_draw_line_dsc_t dsc;
+    lv_draw_line_dsc_init(&dsc);
+    dsc.color = line->color;
+    dsc.opa = line->opa;
+    dsc.width = line->width;
+
+    int segments = line->closed && line->count > 2 ? line->count : line->count - 1;
+    for (int i = 0; i < segments; i++) {
+        int j = (i + 1) % line->count;
+        float x1 = line->vertices[i * 2] + offset_x;
+        float y1 = line->vertices[i * 2 + 1] + offset_y;
+        float x2 = line->vertices[j * 2] + offset_x;
+        float y2 = line->vertices[j * 2 + 1] + offset_y;
+
+        // Long strips mostly fall outside the area being redrawn
+        lv_area_t area;
+        area.x1 = (int32_t)floorf(fminf(x1, x2)) - pad;
+        area.y1 = (int32_t)floorf(fminf(y1, y2)) - pad;
+        area.x2 = (int32_t)ceilf(fmaxf(x1, x2)) + pad;
+        area.y2 = (int32_t)ceilf(fmaxf(y1, y2)) + pad;
+        if (!lv_area_is_on(&area, &layer->_clip_area)) continue;
+
+        // A round end fills the wedge between this segment and the next,
+        // the free ends of an open strip stay square
+        dsc.round_end = line->width > 1 && (line->closed || i < segments - 1);
+        dsc.p1.x = (lv_value_precise_t)x1;
+        dsc.p1.y = (lv_value_precise_t)y1;
+        dsc.p2.x = (lv_value_precise_t)x2;
+        dsc.p2.y = (lv_value_precise_t)y2;
+        lv_draw_line(layer, &dsc);
+    }
+}
+
+static void delete_event_cb(lv_event_t* e) {
+    SparkPolyline* line = lv_event_get_user_data(e);
+    free(line->vertices);
+    free(line);
+}
+
+static bool set_vertices(SparkPolyline* line, const float* vertices, int count) {
+    size_t needed = sizeof(float) * 2 * count;
+    if (needed > line->capacity) {
+        float* grown = realloc(line->vertices, needed);
+        if (!grown) return false;
+        line->vertices = grown;
+        line->capacity = needed;
+    }
+    memcpy(line->vertices, vertices, needed);
+    line->count = count;
+    return true;
+}
+
+lv_obj_t* spark_polyline_create(lv_obj_t* parent, const float* vertices, int count, bool closed) {
+    SparkPolyline* line = calloc(1, sizeof(SparkPolyline));
+    if (!line) return NULL;
+
+    if (!set_vertices(line, vertices, count)) {
+        free(line);
+        return NULL;
+    }
+    line->closed = closed;
+    line->width = 1;
+    line->color = spark_graphics_get_color();
+    line->opa = spark_graphics_get_opacity();
+
+    lv_obj_t* obj = lv_obj_create(parent);
+    if (!obj) {
+        free(line->vertices);
+        free(line);
+        return NULL;
+    }
+    lv_obj_remove_style_all(obj);
+    lv_obj_remove_flag(obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(obj, SPARK_POLYLINE_FLAG);
+    lv_obj_set_user_data(obj, line);
+    lv_obj_add_event_cb(obj, draw_event_cb, LV_EVENT_DRAW_MAIN, line);
+    lv_obj_add_event_cb(obj, delete_event_cb, LV_EVENT_DELETE, line);
+
+    // Forces the first placement to size the object
+    line->x = INT32_MIN;
+    place(obj, line);
+    return obj;
+}
+
+void spark_polyline_update(lv_obj_t* obj, const float* vertices, int count) {
+    SparkPolyline* line = lv_obj_get_user_data(obj);
+    if (!line || !vertices || count < 2) return;
+
+    if (count == line->count && memcmp(line->vertices, vertices, sizeof(float) * 2 * count) == 0) return;
+    if (!set_vertices(line, vertices, count)) return;
+    place(obj, line);
+}
+
+void spark_polyline_set_width(lv_obj_t* obj, int32_t width) {
+    SparkPolyline* line = lv_obj_get_user_data(obj);
+    if (!line || width < 1 || width == line->width) return;
+
+    line->width = width;
+    place(obj, line);
+}
@@ -0,0 +1,676 @@
+// sdf.c
+#include "spark_graphics/sdf.h"
+#include "spark_graphics/font.h"
+#include "spark_graphics/layer.h"
+#include "../internal.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ATLAS_WIDTH 512
+#define ATLAS_INITIAL_HEIGHT 128
+#define EDT_FAR 1e20f
+
+typedef struct {
+    uint32_t letter;
+    int32_t adv_w;
+    int32_t ofs_x;
+    int32_t ofs_y;
+    int32_t box_w;
+    int32_t box_h;
+    int32_t atlas_x;        // Cell of box + 2 * spread on each axis, when box_w > 0
+    int32_t atlas_y;
+} SdfGlyph;
+
+struct SparkSdfFont {
+    SparkFont* source;      // Rasterizes at the base size
+    int base_size;
+    int spread;
+
+    SdfGlyph* glyphs;
+    int glyph_count;
+    int glyph_capacity;
+    int* slots;             // Open addressing, letter to glyph index + 1, 0 is empty
+    int slot_count;         // Power of two, twice the capacity
+
+    // A8 atlas, shelves filled left to right, grown downwards
+    uint8_t* atlas;
+    int32_t atlas_height;
+    int32_t shelf_x;
+    int32_t shelf_y;
+    int32_t shelf_height;
+    lv_image_dsc_t image;
+};
+
+// A glyph of the laid out text, in base pixels from the top-left
+typedef struct {
+    int glyph;
+    float x;
+    float y;
+} SdfPlaced;
+
+typedef struct {
+    float r, g, b, a;
+} SdfColor;
+
+struct SparkSdfText {
+    SparkSdfFont* font;
+    SparkImageObject view;
+    char* string;
+    float x;
+    float y;
+    float size;
+
+    SdfPlaced* placed;
+    int placed_count;
+    int placed_capacity;
+    float layout_width;     // Base pixels
+    float layout_height;
+
+    SdfColor color;
+    SdfColor outline_color;
+    SdfColor glow_color;
+    float outline_width;
+    float glow_radius;
+
+    uint32_t* pixels;
+    float* field;           // Per pixel, the largest signed distance of any glyph
+    size_t pixel_capacity;
+    int32_t margin;
+};
+
+// Glyph table
+
+static uint32_t slot_of(const SparkSdfFont* font, uint32_t letter) {
+    return (letter * 2654435761u) & (uint32_t)(font->slot_count - 1);
+}
+
+static void insert_slot(SparkSdfFont* font, int index) {
+    uint32_t slot = slot_of(font, font->glyphs[index].letter);
+    while (font->slots[slot]) slot = (slot + 1) & (uint32_t)(font->slot_count - 1);
+    font->slots[slot] = index + 1;
+}
+
+static int find_glyph(const SparkSdfFont* font, uint32_t letter) {
+    if (font->slot_count == 0) return -1;
+    uint32_t slot = slot_of(font, letter);
+    while (font->slots[slot]) {
+        int index = font->slots[slot] - 1;
+        if (font->glyphs[index].letter == letter) return index;
+        slot = (slot + 1) & (uint32_t)(font->slot_count - 1);
+    }
+    return -1;
+}
+
+static bool reserve_glyph(SparkSdfFont* font) {
+    if (font->glyph_count < font->glyph_capacity) return true;
+
+    int capacity = font->glyph_capacity > 0 ? font->glyph_capacity * 2 : 128;
+    SdfGlyph* glyphs = realloc(font->glyphs, sizeof(SdfGlyph) * capacity);
+    if (!glyphs) return false;
+    font->glyphs = glyphs;
+
+    int* slots = calloc((size_t)capacity * 2, sizeof(int));
+    if (!slots) return false;
+    free(font->slots);
+    font->slots = slots;
+    font->slot_count = capacity * 2;
+    font->glyph_capacity = capacity;
+    for (int i = 0; i < font->glyph_count; i++) insert_slot(font, i);
+    return true;
+}
+
+// Atlas
+
+static void update_image(SparkSdfFont* font) {
+    lv_image_cache_drop(&font->image);
+    font->image.header.magic = LV_IMAGE_HEADER_MAGIC;
+    font->image.header.cf = LV_COLOR_FORMAT_A8;
+    font->image.header.w = ATLAS_WIDTH;
+    font->image.header.h = font->atlas_height;
+    font->image.header.stride = ATLAS_WIDTH;
+    font->image.data = font->atlas;
+    font->image.data_size = (uint32_t)ATLAS_WIDTH * font->atlas_height;
+}
+
+static bool grow_atlas(SparkSdfFont* font, int32_t height) {
+    int32_t new_height = font->atlas_height;
+    while (new_height < height) new_height *= 2;
+    if (new_height == font->atlas_height) return true;
+
+    uint8_t* atlas = realloc(font->atlas, (size_t)ATLAS_WIDTH * new_height);
+    if (!atlas) return false;
+    memset(atlas + (size_t)ATLAS_WIDTH * font->atlas_height, 0,
+           (size_t)ATLAS_WIDTH * (new_height - font->atlas_height));
+    font->atlas = atlas;
+    font->atlas_height = new_height;
+    update_image(font);
+    return true;
+}
+
+static bool place_cell(SparkSdfFont* font, int32_t w, int32_t h, int32_t* x, int32_t* y) {
+    if (w > ATLAS_WIDTH) return false;
+    if (font->shelf_x + w > ATLAS_WIDTH) {
+        font->shelf_y += font->shelf_height;
+        font->shelf_x = 0;
+        font->shelf_height = 0;
+    }
+    if (!grow_atlas(font, font->shelf_y + h)) return false;
+
+    *x = font->shelf_x;
+    *y = font->shelf_y;
+    font->shelf_x += w;
+    if (h > font->shelf_height) font->shelf_height = h;
+    return true;
+}
+
+// Distance fields
+
+// Squared distances to the nearest zero of f along one row or column
+// (Felzenszwalb and Huttenlocher). v and z hold n and n + 1 entries.
+static void edt_1d(const float* f, float* d, int* v, float* z, int n) {
+    int k = 0;
+    v[0] = 0;
+    z[0] = -EDT_FAR;
+    z[1] = EDT_FAR;
+    for (int q = 1; q < n; q++) {
+        float s;
+        for (;;) {
+            int p = v[k];
+            s = ((f[q] + (float)(q * q)) - (f[p] + (float)(p * p))) / (float)(2 * q - 2 * p);
+            if (s > z[k]) break;
+            k--;
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = EDT_FAR;
+    }
+
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < (float)q) k++;
+        float dq = (float)(q - v[k]);
+        d[q] = dq * dq + f[v[k]];
+    }
+}
+
+// In place over a w by h grid, 0 at features and EDT_FAR elsewhere
+static void edt_2d(float* grid, int w, int h, float* f, float* d, int* v, float* z) {
+    for (int x = 0; x < w; x++) {
+        for (int y = 0; y < h; y++) f[y] = grid[(size_t)y * w + x];
+        edt_1d(f, d, v, z, h);
+        for (int y = 0; y < h; y++) grid[(size_t)y * w + x] = d[y];
+    }
+    for (int y = 0; y < h; y++) {
+        memcpy(f, grid + (size_t)y * w, sizeof(float) * w);
+        edt_1d(f, grid + (size_t)y * w, v, z, w);
+    }
+}
+
+// Coverage of a w by h cell, glyph included, to 128 + 127 * distance /
+// spread, positive inside. Partly covered pixels keep their coverage as a
+// sub-pixel distance to the edge.
+static bool build_field(const uint8_t* coverage, int w, int h, int spread, uint8_t* out, int32_t out_stride) {
+    int n = w > h ? w : h;
+    size_t cells = (size_t)w * h;
+    float* outside = malloc(sizeof(float) * cells);
+    float* inside = malloc(sizeof(float) * cells);
+    float* f = malloc(sizeof(float) * n);
+    float* d = malloc(sizeof(float) * n);
+    int* v = malloc(sizeof(int) * n);
+    float* z = malloc(sizeof(float) * (n + 1));
+    bool ok = outside && inside && f && d && v && z;
+
+    if (ok) {
+        for (size_t i = 0; i < cells; i++) {
+            bool in = coverage[i] >= 128;
+            outside[i] = in ? 0.0f : EDT_FAR;
+            inside[i] = in ? EDT_FAR : 0.0f;
+        }
+        edt_2d(outside, w, h, f, d, v, z);
+        edt_2d(inside, w, h, f, d, v, z);
+
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                size_t i = (size_t)y * w + x;
+                float distance;
+                if (coverage[i] > 0 && coverage[i] < 255) {
+                    distance = (float)coverage[i] / 255.0f - 0.5f;
+                } else if (coverage[i] >= 128) {
+                    distance = sqrtf(inside[i]) - 0.5f;
+                } else {
+                    distance = 0.5f - sqrtf(outside[i]);
+                }
+                float value = 128.0f + 127.0f * distance / (float)spread;
+                out[(size_t)y * out_stride + x] = (uint8_t)(value < 0.0f ? 0.0f : value > 255.0f ? 255.0f : value);
+            }
+        }
+    }
+
+    free(outside);
+    free(inside);
+    free(f);
+    free(d);
+    free(v);
+    free(z);
+    return ok;
+}
+
+// Copies the glyph's A8 bitmap into a cell padded by spread on every side
+static uint8_t* rasterize(SparkSdfFont* font, lv_font_glyph_dsc_t* dsc, int32_t cell_w, int32_t cell_h) {
+    uint8_t* coverage = calloc((size_t)cell_w * cell_h, 1);
+    lv_draw_buf_t* scratch = lv_draw_buf_create(dsc->box_w, dsc->box_h, LV_COLOR_FORMAT_A8, 0);
+    if (!coverage || !scratch) {
+        free(coverage);
+        if (scratch) lv_draw_buf_destroy(scratch);
+        return NULL;
+    }
+
+    const lv_draw_buf_t* bitmap = lv_font_get_glyph_bitmap(dsc, scratch);
+    if (bitmap && bitmap->header.cf == LV_COLOR_FORMAT_A8) {
+        uint32_t stride = bitmap->header.stride ? bitmap->header.stride : bitmap->header.w;
+        int32_t rows = (int32_t)bitmap->header.h < dsc->box_h ? (int32_t)bitmap->header.h : dsc->box_h;
+        int32_t cols = (int32_t)bitmap->header.w < dsc->box_w ? (int32_t)bitmap->header.w : dsc->box_w;
+        for (int32_t y = 0; y < rows; y++) {
+            memcpy(coverage + (size_t)(y + font->spread) * cell_w + font->spread,
+                   bitmap->data + (size_t)y * stride, (size_t)cols);
+        }
+    }
+    lv_font_glyph_release_draw_data(dsc);
+    lv_draw_buf_destroy(scratch);
+    return coverage;
+}
+
+// -1 if the glyph can't be stored
+static int get_glyph(SparkSdfFont* font, uint32_t letter, bool* generated) {
+    int index = find_glyph(font, letter);
+    if (index >= 0) return index;
+    if (!reserve_glyph(font)) return -1;
+
+    const lv_font_t* lv_font = spark_graphics_font_get_lv_font(font->source);
+    lv_font_glyph_dsc_t dsc;
+    memset(&dsc, 0, sizeof(dsc));
+    bool found = lv_font_get_glyph_dsc(lv_font, &dsc, letter, 0);
+
+    SdfGlyph glyph = {
+        .letter = letter,
+        .adv_w = dsc.adv_w,
+        .ofs_x = dsc.ofs_x,
+        .ofs_y = dsc.ofs_y,
+        .box_w = dsc.box_w,
+        .box_h = dsc.box_h
+    };
+
+    if (found && glyph.box_w > 0 && glyph.box_h > 0) {
+        int32_t cell_w = glyph.box_w + 2 * font->spread;
+        int32_t cell_h = glyph.box_h + 2 * font->spread;
+        uint8_t* coverage = rasterize(font, &dsc, cell_w, cell_h);
+        bool ok = coverage && place_cell(font, cell_w, cell_h, &glyph.atlas_x, &glyph.atlas_y) &&
+                  build_field(coverage, cell_w, cell_h, font->spread,
+                              font->atlas + (size_t)glyph.atlas_y * ATLAS_WIDTH + glyph.atlas_x, ATLAS_WIDTH);
+        free(coverage);
+        if (!ok) {
+            // Drawn as empty space rather than retried every time
+            fprintf(stderr, "Failed to generate distance field for U+%04X\n", (unsigned)letter);
+            glyph.box_w = 0;
+            glyph.box_h = 0;
+        }
+        lv_image_cache_drop(&font->image);
+        if (generated) *generated = true;
+    } else {
+        glyph.box_w = 0;
+        glyph.box_h = 0;
+    }
+
+    index = font->glyph_count++;
+    font->glyphs[index] = glyph;
+    insert_slot(font, index);
+    return index;
+}
+
+SparkSdfFont* spark_graphics_sdf_font_new(const char* path, int base_size, int spread) {
+    if (!path || base_size <= 0 || spread < 0) return NULL;
+
+    SparkSdfFont* font = calloc(1, sizeof(SparkSdfFont));
+    if (!font) return NULL;
+    font->source = spark_graphics_new_font(path, base_size);
+    font->atlas = calloc((size_t)ATLAS_WIDTH * ATLAS_INITIAL_HEIGHT, 1);
+    if (!font->source || !font->atlas) {
+        spark_graphics_font_free(font->source);
+        free(font->atlas);
+        free(font);
+        return NULL;
+    }
+
+    font->base_size = base_size;
+    font->spread = spread > 0 ? spread : (base_size / 8 > 2 ? base_size / 8 : 2);
+    font->atlas_height = ATLAS_INITIAL_HEIGHT;
+    update_image(font);
+    return font;
+}
+
+void spark_graphics_sdf_font_free(SparkSdfFont* font) {
+    if (!font) return;
+    lv_image_cache_drop(&font->image);
+    spark_graphics_font_free(font->source);
+    free(font->glyphs);
+    free(font->slots);
+    free(font->atlas);
+    free(font);
+}
+
+int spark_graphics_sdf_font_preload(SparkSdfFont* font, const char* text) {
+    if (!font || !text) return 0;
+
+    int count = 0;
+    uint32_t i = 0;
+    uint32_t letter;
+    while ((letter = lv_text_encoded_next(text, &i)) != 0) {
+        bool generated = false;
+        get_glyph(font, letter, &generated);
+        if (generated) count++;
+    }
+    return count;
+}
+
+const lv_image_dsc_t* spark_graphics_sdf_font_get_atlas(const SparkSdfFont* font) {
+    return font ? &font->image : NULL;
+}
+
+// Text
+
+static bool layout(SparkSdfText* text) {
+    SparkSdfFont* font = text->font;
+    const lv_font_t* lv_font = spark_graphics_font_get_lv_font(font->source);
+    float line_height = (float)lv_font->line_height;
+
+    text->placed_count = 0;
+    text->layout_width = 0.0f;
+    text->layout_height = text->string[0] ? line_height : 0.0f;
+
+    float pen_x = 0.0f;
+    float line_y = 0.0f;
+    uint32_t i = 0;
+    uint32_t letter = lv_text_encoded_next(text->string, &i);
+    while (letter) {
+        uint32_t next = lv_text_encoded_next(text->string, &i);
+        if (letter == '\n') {
+            pen_x = 0.0f;
+            line_y += line_height;
+            text->layout_height += line_height;
+            letter = next;
+            continue;
+        }
+
+        int glyph = get_glyph(font, letter, NULL);
+        if (glyph >= 0) {
+            if (text->placed_count == text->placed_capacity) {
+                int capacity = text->placed_capacity > 0 ? text->placed_capacity * 2 : 32;
+                SdfPlaced* placed = realloc(text->placed, sizeof(SdfPlaced) * capacity);
+                if (!placed) return false;
+                text->placed = placed;
+                text->placed_capacity = capacity;
+            }
+            text->placed[text->placed_count++] = (SdfPlaced){ glyph, pen_x, line_y };
+
+            // Kerned against the next letter
+            pen_x += (float)lv_font_get_glyph_width(lv_font, letter, next);
+            if (pen_x > text->layout_width) text->layout_width = pen_x;
+        }
+        letter = next;
+    }
+    return true;
+}
+
+// NaN comes out as 0
+static float clamp01(float value) {
+    return fminf(fmaxf(value, 0.0f), 1.0f);
+}
+
+// Components are clamped when stored so shading stays in range and packs
+// without spilling into the next channel
+static SdfColor make_color(float r, float g, float b, float a) {
+    return (SdfColor){ clamp01(r), clamp01(g), clamp01(b), clamp01(a) };
+}
+
+// Bilinear sample of the glyph's cell, clamped to the cell
+static float sample_field(const SparkSdfFont* font, const SdfGlyph* glyph, float u, float v) {
+    int32_t cell_w = glyph->box_w + 2 * font->spread;
+    int32_t cell_h = glyph->box_h + 2 * font->spread;
+    float max_u = (float)(cell_w - 1);
+    float max_v = (float)(cell_h - 1);
+    u = u < 0.0f ? 0.0f : u > max_u ? max_u : u;
+    v = v < 0.0f ? 0.0f : v > max_v ? max_v : v;
+
+    int32_t x0 = (int32_t)u;
+    int32_t y0 = (int32_t)v;
+    int32_t x1 = x0 + 1 < cell_w ? x0 + 1 : x0;
+    int32_t y1 = y0 + 1 < cell_h ? y0 + 1 : y0;
+    float fx = u - (float)x0;
+    float fy = v - (float)y0;
+
+    const uint8_t* row0 = font->atlas + (size_t)(glyph->atlas_y + y0) * ATLAS_WIDTH + glyph->atlas_x;
+    const uint8_t* row1 = font->atlas + (size_t)(glyph->atlas_y + y1) * ATLAS_WIDTH + glyph->atlas_x;
+    float top = (float)row0[x0] + ((float)row0[x1] - (float)row0[x0]) * fx;
+    float bottom = (float)row1[x0] + ((float)row1[x1] - (float)row1[x0]) * fx;
+    return top + (bottom - top) * fy;
+}
+
+// Straight-alpha src over dst
+static void composite(SdfColor* dst, float r, float g, float b, float a) {
+    float under = dst->a * (1.0f - a);
+    float out = a + under;
+    if (out <= 0.0f) return;
+    dst->r = (r * a + dst->r * under) / out;
+    dst->g = (g * a + dst->g * under) / out;
+    dst->b = (b * a + dst->b * under) / out;
+    dst->a = out;
+}
+
+// Outline and glow already clamped to what the field reaches
+static void shade(SparkSdfText* text, int32_t w, int32_t h, float outline_width, float glow_radius) {
+    for (size_t i = 0; i < (size_t)w * h; i++) {
+        float distance = text->field[i];
+        SdfColor pixel = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        if (glow_radius > 0.0f) {
+            float t = distance >= 0.0f ? 1.0f : clamp01(1.0f + distance / glow_radius);
+            const SdfColor* c = &text->glow_color;
+            composite(&pixel, c->r, c->g, c->b, c->a * t * t);
+        }
+        if (outline_width > 0.0f) {
+            const SdfColor* c = &text->outline_color;
+            composite(&pixel, c->r, c->g, c->b, c->a * clamp01(distance + outline_width + 0.5f));
+        }
+        const SdfColor* c = &text->color;
+        composite(&pixel, c->r, c->g, c->b, c->a * clamp01(distance + 0.5f));
+
+        text->pixels[i] = (uint32_t)(pixel.a * 255.0f + 0.5f) << 24 |
+                          (uint32_t)(pixel.r * 255.0f + 0.5f) << 16 |
+                          (uint32_t)(pixel.g * 255.0f + 0.5f) << 8 |
+                          (uint32_t)(pixel.b * 255.0f + 0.5f);
+    }
+}
+
+// Redraws the text's pixels at its current size and resizes the object
+static void render(SparkSdfText* text) {
+    SparkSdfFont* font = text->font;
+    const lv_font_t* lv_font = spark_graphics_font_get_lv_font(font->source);
+    float scale = text->size / (float)font->base_size;
+
+    // Past the spread every pixel reads as equally far, so wider outlines
+    // and glows would cover the whole image
+    float field_reach = (float)font->spread * scale;
+    float outline_width = fminf(text->outline_width, field_reach - 0.5f);
+    float glow_radius = fminf(text->glow_radius, field_reach);
+    if (outline_width < 0.0f) outline_width = 0.0f;
+    float reach = outline_width > glow_radius ? outline_width : glow_radius;
+    int32_t margin = (int32_t)ceilf(reach) + 1;
+    int32_t w = (int32_t)ceilf(text->layout_width * scale) + 2 * margin;
+    int32_t h = (int32_t)ceilf(text->layout_height * scale) + 2 * margin;
+
+    if (text->placed_count == 0 || scale <= 0.0f) {
+        lv_obj_add_flag(text->view.object, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+
+    size_t pixels = (size_t)w * h;
+    if (pixels > text->pixel_capacity) {
+        uint32_t* buffer = malloc(sizeof(uint32_t) * pixels);
+        float* field = malloc(sizeof(float) * pixels);
+        if (!buffer || !field) {
+            fprintf(stderr, "Failed to allocate %dx%d SDF text\n", (int)w, (int)h);
+            free(buffer);
+            free(field);
+            lv_obj_add_flag(text->view.object, LV_OBJ_FLAG_HIDDEN);
+            return;
+        }
+        lv_image_cache_drop(&text->view.image);
+        free(text->pixels);
+        free(text->field);
+        text->pixels = buffer;
+        text->field = field;
+        text->pixel_capacity = pixels;
+    }
+
+    // Distances in output pixels, the field saturates at the spread
+    float far = -field_reach;
+    for (size_t i = 0; i < pixels; i++) text->field[i] = far;
+
+    float baseline = (float)(lv_font->line_height - lv_font->base_line);
+    float to_distance = (float)font->spread * scale / 127.0f;
+    for (int p = 0; p < text->placed_count; p++) {
+        const SdfPlaced* placed = &text->placed[p];
+        const SdfGlyph* glyph = &font->glyphs[placed->glyph];
+        if (glyph->box_w <= 0) continue;
+
+        // Cell corner in output pixels, where LVGL would put the glyph box minus the spread
+        float cell_x = (float)margin + (placed->x + (float)(glyph->ofs_x - font->spread)) * scale;
+        float cell_y = (float)margin + (placed->y + baseline - (float)(glyph->ofs_y + glyph->box_h + font->spread)) * scale;
+        float cell_w = (float)(glyph->box_w + 2 * font->spread) * scale;
+        float cell_h = (float)(glyph->box_h + 2 * font->spread) * scale;
+
+        int32_t x0 = (int32_t)floorf(cell_x), y0 = (int32_t)floorf(cell_y);
+        int32_t x1 = (int32_t)ceilf(cell_x + cell_w), y1 = (int32_t)ceilf(cell_y + cell_h);
+        if (x0 < 0) x0 = 0;
+        if (y0 < 0) y0 = 0;
+        if (x1 > w) x1 = w;
+        if (y1 > h) y1 = h;
+
+        for (int32_t y = y0; y < y1; y++) {
+            float v = ((float)y + 0.5f - cell_y) / scale - 0.5f;
+            float* row = text->field + (size_t)y * w;
+            for (int32_t x = x0; x < x1; x++) {
+                float u = ((float)x + 0.5f - cell_x) / scale - 0.5f;
+                float distance = (sample_field(font, glyph, u, v) - 128.0f) * to_distance;
+                if (distance > row[x]) row[x] = distance;
+            }
+        }
+    }
+    shade(text, w, h, outline_width, glow_radius);
+
+    text->margin = margin;
+    spark_image_object_set_pixels(&text->view, text->pixels, w, h, w);
+
+    lv_obj_remove_flag(text->view.object, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_pos(text->view.object, (int32_t)lroundf(text->x) - margin, (int32_t)lroundf(text->y) - margin);
+    lv_obj_invalidate(text->view.object);
+}
+
+SparkSdfText* spark_graphics_sdf_text_new(SparkSdfFont* font, const char* string, float x, float y, float size) {
+    if (!font || !string) return NULL;
+
+    SparkSdfText* text = calloc(1, sizeof(SparkSdfText));
+    if (!text) return NULL;
+    text->string = strdup(string);
+    bool created = spark_image_object_create(&text->view, x, y, NULL, NULL);
+    if (!text->string || !created) {
+        spark_image_object_free(&text->view);
+        free(text->string);
+        free(text);
+        return NULL;
+    }
+
+    text->font = font;
+    text->x = x;
+    text->y = y;
+    text->size = size;
+    text->color = (SdfColor){ 1.0f, 1.0f, 1.0f, 1.0f };
+
+    layout(text);
+    render(text);
+    return text;
+}
+
+void spark_graphics_sdf_text_free(SparkSdfText* text) {
+    if (!text) return;
+    spark_image_object_free(&text->view);
+    free(text->string);
+    free(text->placed);
+    free(text->pixels);
+    free(text->field);
+    free(text);
+}
+
+lv_obj_t* spark_graphics_sdf_text_get_object(SparkSdfText* text) {
+    return text ? text->view.object : NULL;
+}
+
+void spark_graphics_sdf_text_set_text(SparkSdfText* text, const char* string) {
+    if (!text || !text->view.object || !string || strcmp(text->string, string) == 0) return;
+    SPARK_TRACE_INVALIDATION(text->view.object);
+
+    char* copy = strdup(string);
+    if (!copy) return;
+    free(text->string);
+    text->string = copy;
+    layout(text);
+    render(text);
+}
+
+void spark_graphics_sdf_text_set_position(SparkSdfText* text, float x, float y) {
+    if (!text || !text->view.object) return;
+    SPARK_TRACE_INVALIDATION(text->view.object);
+    text->x = x;
+    text->y = y;
+    lv_obj_set_pos(text->view.object, (int32_t)lroundf(x) - text->margin, (int32_t)lroundf(y) - text->margin);
+}
+
+// Only resamples the atlas, no glyph is rasterized again
+void spark_graphics_sdf_text_set_size(SparkSdfText* text, float size) {
+    if (!text || !text->view.object || size == text->size) return;
+    SPARK_TRACE_INVALIDATION(text->view.object);
+    text->size = size;
+    render(text);
+}
+
+void spark_graphics_sdf_text_set_color(SparkSdfText* text, float r, float g, float b, float a) {
+    if (!text || !text->view.object) return;
+    SPARK_TRACE_INVALIDATION(text->view.object);
+    text->color = make_color(r, g, b, a);
+    render(text);
+}
+
+void spark_graphics_sdf_text_set_outline(SparkSdfText* text, float width, float r, float g, float b, float a) {
+    if (!text || !text->view.object) return;
+    SPARK_TRACE_INVALIDATION(text->view.object);
+    text->outline_width = width > 0.0f ? width : 0.0f;
+    text->outline_color = make_color(r, g, b, a);
+    render(text);
+}
+
+void spark_graphics_sdf_text_set_glow(SparkSdfText* text, float radius, float r, float g, float b, float a) {
+    if (!text || !text->view.object) return;
+    SPARK_TRACE_INVALIDATION(text->view.object);
+    text->glow_radius = radius > 0.0f ? radius : 0.0f;
+    text->glow_color = make_color(r, g, b, a);
+    render(text);
+}
+
+void spark_graphics_sdf_text_get_size(const SparkSdfText* text, float* width, float* height) {
+    float scale = text ? text->size / (float)text->font->base_size : 0.0f;
+    if (width) *width = text ? text->layout_width * scale : 0.0f;
+    if (height) *height = text ? text->layout_height * scale : 0.0f;
+}
@@ -0,0 +1,402 @@
+// sprite_batch.c
+#include "spark_graphics/sprite_batch.h"
+#include "spark_graphics/layer.h"
+#include "spark_graphics/blend.h"
+#include "../internal.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define INITIAL_CAPACITY 64
+#define WHITE 0xFFFFFFFFu
+
+struct SparkSpriteBatch {
+    SparkImageObject view;  // Composited when it changed, before it draws
+    float x;                // Region origin, subtracted from every sprite
+    float y;
+    int32_t width;
+    int32_t height;
+
+    uint32_t* source;       // Decoded image, 0xAARRGGBB
+    int32_t source_width;
+    int32_t source_height;
+
+    SparkSpriteArrays arrays;
+    int capacity;
+
+    uint32_t* pixels;
+    uint32_t* row;          // One row of tinted or resampled pixels for blend modes
+};
+
+static inline uint32_t mul8(uint32_t a, uint32_t b) {
+    uint32_t t = a * b + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+// Straight-alpha source over destination
+static inline uint32_t blend_over(uint32_t dst, uint32_t src) {
+    uint32_t sa = src >> 24;
+    if (sa == 255) return src;
+    if (sa == 0) return dst;
+    uint32_t da = dst >> 24;
+    if (da == 0) return src;
+
+    uint32_t dst_weight = mul8(da, 255 - sa);
+    uint32_t out_a = sa + dst_weight;
+    uint32_t half = out_a / 2;
+    uint32_t r = (((src >> 16) & 0xFF) * sa + ((dst >> 16) & 0xFF) * dst_weight + half) / out_a;
+    uint32_t g = (((src >> 8) & 0xFF) * sa + ((dst >> 8) & 0xFF) * dst_weight + half) / out_a;
+    uint32_t b = ((src & 0xFF) * sa + (dst & 0xFF) * dst_weight + half) / out_a;
+    return out_a << 24 | r << 16 | g << 8 | b;
+}
+
+static inline uint32_t modulate(uint32_t pixel, uint32_t color) {
+    return mul8(pixel >> 24, color >> 24) << 24 |
+           mul8((pixel >> 16) & 0xFF, (color >> 16) & 0xFF) << 16 |
+           mul8((pixel >> 8) & 0xFF, (color >> 8) & 0xFF) << 8 |
+           mul8(pixel & 0xFF, color & 0xFF);
+}
+
+// Untinted rows: runs of opaque pixels are stored four at a time and fully
+// transparent runs skipped, only edges go through the blend
+static void blit_row(uint32_t* dst, const uint32_t* src, int count) {
+    int i = 0;
+
+#if defined(__SSE2__)
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000u);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i a = _mm_and_si128(s, alpha);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, alpha)) == 0xFFFF) {
+            _mm_storeu_si128((__m128i*)(dst + i), s);
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, zero)) == 0xFFFF) continue;
+
+        for (int k = 0; k < 4; k++) {
+            dst[i + k] = blend_over(dst[i + k], src[i + k]);
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        dst[i] = blend_over(dst[i], src[i]);
+    }
+}
+
+static void blit_row_tinted(uint32_t* dst, const uint32_t* src, int count, uint32_t color) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = blend_over(dst[i], modulate(src[i], color));
+    }
+}
+
+static void draw_untransformed(SparkSpriteBatch* batch, int index, const uint16_t* region, float x, float y) {
+    uint32_t color = batch->arrays.colors[index];
+    SparkBlendMode mode = batch->arrays.blend_modes[index];
+
+    int32_t dst_x = (int32_t)floorf(x + 0.5f);
+    int32_t dst_y = (int32_t)floorf(y + 0.5f);
+    int32_t src_x = region[0];
+    int32_t src_y = region[1];
+    int32_t w = region[2];
+    int32_t h = region[3];
+
+    // Clip to the batch region
+    if (dst_x < 0) { src_x -= dst_x; w += dst_x; dst_x = 0; }
+    if (dst_y < 0) { src_y -= dst_y; h += dst_y; dst_y = 0; }
+    if (dst_x + w > batch->width) w = batch->width - dst_x;
+    if (dst_y + h > batch->height) h = batch->height - dst_y;
+    if (w <= 0 || h <= 0) return;
+
+    for (int32_t row = 0; row < h; row++) {
+        uint32_t* dst = batch->pixels + (size_t)(dst_y + row) * batch->width + dst_x;
+        const uint32_t* src = batch->source + (size_t)(src_y + row) * batch->source_width + src_x;
+        if (mode != SPARK_BLEND_NORMAL) {
+            if (color != WHITE) {
+                for (int32_t i = 0; i < w; i++) batch->row[i] = modulate(src[i], color);
+                src = batch->row;
+            }
+            spark_graphics_blend_span(mode, dst, src, w);
+        } else if (color == WHITE) {
+            blit_row(dst, src, w);
+        } else {
+            blit_row_tinted(dst, src, w, color);
+        }
+    }
+}
+
+// Each covered pixel center maps back into the source region, nearest
+// neighbour, so scaled pixel art stays sharp
+static void draw_transformed(SparkSpriteBatch* batch, int index, const uint16_t* region, float x, float y,
+                             float rotation, float scale) {
+    uint32_t color = batch->arrays.colors[index];
+    SparkBlendMode mode = batch->arrays.blend_modes[index];
+    float w = region[2];
+    float h = region[3];
+    if (scale <= 0.0f || w == 0.0f || h == 0.0f) return;
+
+    float cs = cosf(rotation);
+    float sn = sinf(rotation);
+    float cx = x + w / 2;
+    float cy = y + h / 2;
+    float half_w = (fabsf(cs) * w + fabsf(sn) * h) * scale / 2;
+    float half_h = (fabsf(sn) * w + fabsf(cs) * h) * scale / 2;
+
+    int32_t x1 = (int32_t)floorf(cx - half_w);
+    int32_t y1 = (int32_t)floorf(cy - half_h);
+    int32_t x2 = (int32_t)ceilf(cx + half_w);
+    int32_t y2 = (int32_t)ceilf(cy + half_h);
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 > batch->width) x2 = batch->width;
+    if (y2 > batch->height) y2 = batch->height;
+
+    float inv = 1.0f / scale;
+    const uint32_t* source = batch->source + (size_t)region[1] * batch->source_width + region[0];
+
+    for (int32_t py = y1; py < y2; py++) {
+        float dx = (float)x1 + 0.5f - cx;
+        float dy = (float)py + 0.5f - cy;
+        float u = (dx * cs + dy * sn) * inv + w / 2;
+        float v = (dy * cs - dx * sn) * inv + h / 2;
+        uint32_t* dst = batch->pixels + (size_t)py * batch->width;
+
+        // Other modes resample the row first, misses stay transparent
+        bool normal = mode == SPARK_BLEND_NORMAL;
+        for (int32_t px = x1; px < x2; px++) {
+            uint32_t pixel = 0;
+            if (u >= 0.0f && v >= 0.0f && u < w && v < h) {
+                pixel = source[(size_t)v * batch->source_width + (size_t)u];
+                if (color != WHITE) pixel = modulate(pixel, color);
+                if (normal) dst[px] = blend_over(dst[px], pixel);
+            }
+            if (!normal) batch->row[px - x1] = pixel;
+            u += cs * inv;
+            v -= sn * inv;
+        }
+        if (!normal && x2 > x1) spark_graphics_blend_span(mode, dst + x1, batch->row, x2 - x1);
+    }
+}
+
+// Regions may be written directly, so they are clipped to the source
+// before anything reads it. False when nothing is left.
+static bool clip_region(const SparkSpriteBatch* batch, const uint16_t* region, uint16_t* clipped) {
+    if (region[0] >= batch->source_width || region[1] >= batch->source_height) return false;
+    clipped[0] = region[0];
+    clipped[1] = region[1];
+    clipped[2] = (uint16_t)(region[2] < batch->source_width - region[0] ? region[2] : batch->source_width - region[0]);
+    clipped[3] = (uint16_t)(region[3] < batch->source_height - region[1] ? region[3] : batch->source_height - region[1]);
+    return clipped[2] > 0 && clipped[3] > 0;
+}
+
+static void composite(void* owner) {
+    SparkSpriteBatch* batch = owner;
+    memset(batch->pixels, 0, (size_t)batch->width * batch->height * 4);
+
+    const SparkSpriteArrays* arrays = &batch->arrays;
+    for (int i = 0; i < arrays->count; i++) {
+        uint16_t region[4];
+        if ((arrays->colors[i] >> 24) == 0 || !clip_region(batch, arrays->regions + i * 4, region)) continue;
+
+        float x = arrays->xy[i * 2] - batch->x;
+        float y = arrays->xy[i * 2 + 1] - batch->y;
+        if (arrays->rotations[i] == 0.0f && arrays->scales[i] == 1.0f) {
+            draw_untransformed(batch, i, region, x, y);
+        } else {
+            draw_transformed(batch, i, region, x, y, arrays->rotations[i], arrays->scales[i]);
+        }
+    }
+}
+
+static SparkSpriteBatch* create(const void* src, float x, float y, float w, float h) {
+    if (w < 1.0f || h < 1.0f) return NULL;
+
+    SparkSpriteBatch* batch = calloc(1, sizeof(SparkSpriteBatch));
+    if (!batch) return NULL;
+
+    batch->source = spark_image_decode_argb8888(src, &batch->source_width, &batch->source_height);
+    if (!batch->source || batch->source_width > UINT16_MAX || batch->source_height > UINT16_MAX) {
+        fprintf(stderr, "Failed to load sprite batch image\n");
+        free(batch->source);
+        free(batch);
+        return NULL;
+    }
+
+    batch->x = x;
+    batch->y = y;
+    batch->width = (int32_t)w;
+    batch->height = (int32_t)h;
+    batch->pixels = calloc((size_t)batch->width * batch->height, 4);
+    batch->row = malloc((size_t)batch->width * 4);
+    bool created = spark_image_object_create(&batch->view, x, y, composite, batch);
+    if (!batch->pixels || !batch->row || !created) {
+        spark_image_object_free(&batch->view);
+        free(batch->row);
+        free(batch->pixels);
+        free(batch->source);
+        free(batch);
+        return NULL;
+    }
+
+    spark_image_object_set_pixels(&batch->view, batch->pixels, batch->width, batch->height, batch->width);
+    return batch;
+}
+
+SparkSpriteBatch* spark_graphics_sprite_batch_new(const char* path, float x, float y, float w, float h) {
+    if (!path) return NULL;
+
+    char full_path[1024];
+    snprintf(full_path, sizeof(full_path), "A:%s", path);
+    return create(full_path, x, y, w, h);
+}
+
+SparkSpriteBatch* spark_graphics_sprite_batch_new_from_image(const lv_image_dsc_t* image,
+                                                             float x, float y, float w, float h) {
+    if (!image) return NULL;
+    return create(image, x, y, w, h);
+}
+
+void spark_graphics_sprite_batch_free(SparkSpriteBatch* batch) {
+    if (!batch) return;
+    spark_image_object_free(&batch->view);
+    free(batch->arrays.xy);
+    free(batch->arrays.regions);
+    free(batch->arrays.rotations);
+    free(batch->arrays.scales);
+    free(batch->arrays.colors);
+    free(batch->arrays.blend_modes);
+    free(batch->source);
+    free(batch->pixels);
+    free(batch->row);
+    free(batch);
+}
+
+lv_obj_t* spark_graphics_sprite_batch_get_object(SparkSpriteBatch* batch) {
+    return batch ? batch->view.object : NULL;
+}
+
+static void mark_dirty(SparkSpriteBatch* batch) {
+    spark_image_object_changed(&batch->view);
+}
+
+static bool grow(void** array, size_t element_size, int capacity) {
+    void* grown = realloc(*array, element_size * capacity);
+    if (!grown) return false;
+    *array = grown;
+    return true;
+}
+
+static bool reserve(SparkSpriteBatch* batch, int needed) {
+    if (needed <= batch->capacity) return true;
+
+    int capacity = batch->capacity > 0 ? batch->capacity * 2 : INITIAL_CAPACITY;
+    SparkSpriteArrays* arrays = &batch->arrays;
+    if (!grow((void**)&arrays->xy, sizeof(float) * 2, capacity) ||
+        !grow((void**)&arrays->regions, sizeof(uint16_t) * 4, capacity) ||
+        !grow((void**)&arrays->rotations, sizeof(float), capacity) ||
+        !grow((void**)&arrays->scales, sizeof(float), capacity) ||
+        !grow((void**)&arrays->colors, sizeof(uint32_t), capacity) ||
+        !grow((void**)&arrays->blend_modes, sizeof(uint8_t), capacity)) {
+        return false;
+    }
+    batch->capacity = capacity;
+    return true;
+}
+
+int spark_graphics_sprite_batch_add(SparkSpriteBatch* batch, float x, float y) {
+    if (!batch || !reserve(batch, batch->arrays.count + 1)) return -1;
+    SPARK_TRACE_INVALIDATION(batch->view.object);
+
+    SparkSpriteArrays* arrays = &batch->arrays;
+    int i = arrays->count++;
+    arrays->xy[i * 2] = x;
+    arrays->xy[i * 2 + 1] = y;
+    arrays->regions[i * 4] = 0;
+    arrays->regions[i * 4 + 1] = 0;
+    arrays->regions[i * 4 + 2] = (uint16_t)batch->source_width;
+    arrays->regions[i * 4 + 3] = (uint16_t)batch->source_height;
+    arrays->rotations[i] = 0.0f;
+    arrays->scales[i] = 1.0f;
+    arrays->colors[i] = WHITE;
+    arrays->blend_modes[i] = (uint8_t)spark_graphics_get_blend_mode();
+    mark_dirty(batch);
+    return i;
+}
+
+void spark_graphics_sprite_batch_clear(SparkSpriteBatch* batch) {
+    if (!batch || batch->arrays.count == 0) return;
+    SPARK_TRACE_INVALIDATION(batch->view.object);
+    batch->arrays.count = 0;
+    mark_dirty(batch);
+}
+
+void spark_graphics_sprite_batch_set_position(SparkSpriteBatch* batch, int index, float x, float y) {
+    if (!batch || index < 0 || index >= batch->arrays.count) return;
+    SPARK_TRACE_INVALIDATION(batch->view.object);
+    batch->arrays.xy[index * 2] = x;
+    batch->arrays.xy[index * 2 + 1] = y;
+    mark_dirty(batch);
+}
+
+void spark_graphics_sprite_batch_set_region(SparkSpriteBatch* batch, int index, int x, int y, int w, int h) {
+    if (!batch || index < 0 || index >= batch->arrays.count) return;
+    if (x < 0 || y < 0 || w < 0 || h < 0 ||
+        x + w > batch->source_width || y + h > batch->source_height) {
+        fprintf(stderr, "Sprite region %d,%d %dx%d is outside the image\n", x, y, w, h);
+        return;
+    }
+    SPARK_TRACE_INVALIDATION(batch->view.object);
+
+    uint16_t* region = batch->arrays.regions + index * 4;
+    region[0] = (uint16_t)x;
+    region[1] = (uint16_t)y;
+    region[2] = (uint16_t)w;
+    region[3] = (uint16_t)h;
+    mark_dirty(batch);
+}
+
+void spark_graphics_sprite_batch_set_transform(SparkSpriteBatch* batch, int index, float rotation, float scale) {
+    if (!batch || index < 0 || index >= batch->arrays.count) return;
+    SPARK_TRACE_INVALIDATION(batch->view.object);
+    batch->arrays.rotations[index] = rotation;
+    batch->arrays.scales[index] = scale;
+    mark_dirty(batch);
+}
+
+// Clamped first, out of range values would spill into the next channel
+static uint32_t to_channel(float value) {
+    return (uint32_t)(fminf(fmaxf(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+void spark_graphics_sprite_batch_set_color(SparkSpriteBatch* batch, int index, float r, float g, float b, float a) {
+    if (!batch || index < 0 || index >= batch->arrays.count) return;
+    SPARK_TRACE_INVALIDATION(batch->view.object);
+    batch->arrays.colors[index] = to_channel(a) << 24 | to_channel(r) << 16 |
+                                  to_channel(g) << 8 | to_channel(b);
+    mark_dirty(batch);
+}
+
+void spark_graphics_sprite_batch_set_blend_mode(SparkSpriteBatch* batch, int index, SparkBlendMode mode) {
+    if (!batch || index < 0 || index >= batch->arrays.count) return;
+    if (mode < SPARK_BLEND_NORMAL || mode >= SPARK_BLEND_MODE_COUNT) return;
+    SPARK_TRACE_INVALIDATION(batch->view.object);
+    batch->arrays.blend_modes[index] = (uint8_t)mode;
+    mark_dirty(batch);
+}
+
+SparkSpriteArrays* spark_graphics_sprite_batch_get_arrays(SparkSpriteBatch* batch) {
+    return batch ? &batch->arrays : NULL;
+}
+
+void spark_graphics_sprite_batch_changed(SparkSpriteBatch* batch) {
+    if (!batch) return;
+    SPARK_TRACE_INVALIDATION(batch->view.object);
+    mark_dirty(batch);
+}
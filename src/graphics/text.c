@@ -1,5 +1,6 @@
 // spark_graphics/text.c
 #include "spark_graphics/text.h"
+#include "spark_graphics/color.h"
 #include "../internal.h"
 #include <stdlib.h>
 #include <string.h>
@@ -26,67 +27,309 @@ SparkText* spark_graphics_new_text(const char* text) {
     txt->scale = 1.0f;
 
     // Calculate dimensions
-    lv_point_t size;
-    lv_txt_get_size(&size, text, LV_FONT_DEFAULT, 
-                    0, 0, LV_COORD_MAX, 0);
-    txt->width = size.x;
-    txt->height = size.y;
+    int32_t width, height;
+    spark_graphics_measure_text(text, LV_FONT_DEFAULT, 0, 0, 0, &width, &height);
+    txt->width = width;
+    txt->height = height;
 
     return txt;
 }
 
-void spark_graphics_text_draw(SparkText* text, float x, float y) {
-    if (!text || !text->text || !text->style) return;
-
-    // Create label object
-    lv_obj_t* label = lv_label_create(lv_scr_act());
-    if (!label) return;
-
-    // Apply style and position
-    lv_obj_add_style(label, text->style, 0);
-    lv_obj_set_pos(label, (lv_coord_t)x, (lv_coord_t)y);
-    lv_obj_set_size(label, 
-                    (lv_coord_t)(text->width * text->scale), 
-                    (lv_coord_t)(text->height * text->scale));
-    
-    // Set text
-    lv_label_set_text(label, text->text);
+// Measurements: open addressing over MEASURE_SLOTS, probing at most
+// MEASURE_PROBES slots. A full probe window replaces its least recently
+// used entry in place, so slots never empty again and no tombstones are
+// needed. The string is kept to rule out hash collisions.
+#define MEASURE_SLOTS 1024
+#define MEASURE_PROBES 8
+
+typedef struct {
+    uint64_t hash;
+    char* text;             // NULL while the slot is empty
+    const lv_font_t* font;  // NULL once the font is freed, never matches
+    int32_t letter_space;
+    int32_t line_space;
+    int32_t max_width;
+    int32_t width;
+    int32_t height;
+    uint32_t last_used;
+} Measurement;
+
+static struct {
+    Measurement slots[MEASURE_SLOTS];
+    uint32_t clock;
+    unsigned long hits;     // Read by the stats exporter thread
+    unsigned long misses;
+} measures = {0};
 
-    // Queue deletion after render
-    lv_obj_add_flag(label, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_del_async(label);
+static uint64_t hash_measure(const char* text, const lv_font_t* font, int32_t letter_space,
+                             int32_t line_space, int32_t max_width) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        hash = (hash ^ *c) * 1099511628211ull;
+    }
+    hash ^= (uint64_t)((uintptr_t)font >> 4) * 0x9E3779B97F4A7C15ull;
+    hash ^= ((uint64_t)(uint32_t)max_width << 32 | (uint32_t)(letter_space * 65599 + line_space)) * 0xC2B2AE3D27D4EB4Full;
+    return hash;
 }
 
-void spark_graphics_print(const char* text, float x, float y) {
-    SparkText* txt = spark_graphics_new_text(text);
-    if (!txt) return;
-    
-    spark_graphics_text_draw(txt, x, y);
-    spark_graphics_text_free(txt);
+void spark_graphics_measure_text(const char* text, const lv_font_t* font, int32_t letter_space,
+                                 int32_t line_space, int32_t wrap_width, int32_t* width, int32_t* height) {
+    if (width) *width = 0;
+    if (height) *height = 0;
+    if (!text) return;
+    if (!font) font = spark_font_get_current();
+    int32_t max_width = wrap_width > 0 ? wrap_width : LV_COORD_MAX;
+
+    uint64_t hash = hash_measure(text, font, letter_space, line_space, max_width);
+    uint32_t start = (uint32_t)hash & (MEASURE_SLOTS - 1);
+    Measurement* victim = NULL;
+
+    for (uint32_t i = 0; i < MEASURE_PROBES; i++) {
+        Measurement* slot = &measures.slots[(start + i) & (MEASURE_SLOTS - 1)];
+        if (!slot->text) {
+            victim = slot;
+            break;
+        }
+        if (slot->hash == hash && slot->font == font && slot->letter_space == letter_space &&
+            slot->line_space == line_space && slot->max_width == max_width &&
+            strcmp(slot->text, text) == 0) {
+            slot->last_used = ++measures.clock;
+            __atomic_store_n(&measures.hits, measures.hits + 1, __ATOMIC_RELAXED);
+            if (width) *width = slot->width;
+            if (height) *height = slot->height;
+            return;
+        }
+        if (!victim || slot->last_used < victim->last_used) victim = slot;
+    }
+
+    __atomic_store_n(&measures.misses, measures.misses + 1, __ATOMIC_RELAXED);
+    lv_point_t size;
+    lv_text_get_size(&size, text, font, letter_space, line_space, max_width, LV_TEXT_FLAG_NONE);
+    if (width) *width = size.x;
+    if (height) *height = size.y;
+
+    char* copy = strdup(text);
+    if (!copy) return;
+    free(victim->text);
+    victim->hash = hash;
+    victim->text = copy;
+    victim->font = font;
+    victim->letter_space = letter_space;
+    victim->line_space = line_space;
+    victim->max_width = max_width;
+    victim->width = size.x;
+    victim->height = size.y;
+    victim->last_used = ++measures.clock;
 }
 
-void spark_graphics_printf(const char* text, float x, float y, float wrap_width, SparkTextAlign align) {
-    SparkText* txt = spark_graphics_new_text(text);
-    if (!txt) return;
+void spark_text_measure_get_counts(unsigned long* hits, unsigned long* misses) {
+    *hits = __atomic_load_n(&measures.hits, __ATOMIC_RELAXED);
+    *misses = __atomic_load_n(&measures.misses, __ATOMIC_RELAXED);
+}
+
+void spark_text_measure_reset_counts(void) {
+    __atomic_store_n(&measures.hits, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&measures.misses, 0, __ATOMIC_RELAXED);
+}
+
+// Text runs: each distinct (string, font, wrap width, alignment) is copied
+// and measured once, then drawn from the copy by draw-list commands. Runs
+// referenced by a command stay; unreferenced ones are kept for reuse up to
+// RUN_CACHE_SIZE and then recycled least recently used first.
+#define RUN_CACHE_SIZE 256
+#define RUN_BUCKETS 512
+
+typedef struct {
+    uint32_t id;            // Serial in the high half, slot in the low half
+    uint32_t hash;
+    char* text;
+    const lv_font_t* font;
+    int32_t wrap_width;
+    lv_text_align_t align;
+    int32_t width;
+    int32_t height;
+    int refs;
+    uint32_t last_used;
+    int next;               // Bucket chain, slot + 1, 0 ends it
+} TextRun;
+
+static struct {
+    TextRun* runs;
+    int count;
+    int capacity;
+    int buckets[RUN_BUCKETS];  // Slot + 1, 0 is empty
+    uint32_t serial;
+    uint32_t clock;
+} cache = {0};
+
+static uint32_t hash_run(const char* text, const lv_font_t* font, int32_t wrap_width, lv_text_align_t align) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        hash = (hash ^ *c) * 16777619u;
+    }
+    hash ^= (uint32_t)((uintptr_t)font >> 4) * 2654435761u;
+    hash ^= (uint32_t)wrap_width * 40503u + (uint32_t)align;
+    return hash;
+}
+
+static TextRun* find_run(uint32_t id) {
+    int slot = (int)(id & 0xFFFF);
+    if (id == 0 || slot >= cache.count || cache.runs[slot].id != id) return NULL;
+    return &cache.runs[slot];
+}
+
+static void unlink_run(int slot) {
+    int* link = &cache.buckets[cache.runs[slot].hash % RUN_BUCKETS];
+    while (*link && *link != slot + 1) link = &cache.runs[*link - 1].next;
+    if (*link) *link = cache.runs[slot].next;
+}
+
+// Least recently used unreferenced run once the cache is full, otherwise a
+// new slot. -1 when out of memory or slots.
+static int claim_slot(void) {
+    if (cache.count >= RUN_CACHE_SIZE) {
+        int oldest = -1;
+        for (int i = 0; i < cache.count; i++) {
+            const TextRun* run = &cache.runs[i];
+            if (run->refs == 0 && (oldest < 0 || run->last_used < cache.runs[oldest].last_used)) oldest = i;
+        }
+        if (oldest >= 0) {
+            unlink_run(oldest);
+            free(cache.runs[oldest].text);
+            return oldest;
+        }
+    }
+
+    if (cache.count > 0xFFFF) return -1;
+    if (cache.count == cache.capacity) {
+        int capacity = cache.capacity > 0 ? cache.capacity * 2 : 64;
+        TextRun* runs = realloc(cache.runs, sizeof(TextRun) * capacity);
+        if (!runs) return -1;
+        cache.runs = runs;
+        cache.capacity = capacity;
+    }
+    return cache.count++;
+}
 
-    // Configure alignment
+uint32_t spark_text_run_acquire(const char* text, const lv_font_t* font, int32_t wrap_width,
+                                lv_text_align_t align) {
+    if (!text || !font) return 0;
+    uint32_t hash = hash_run(text, font, wrap_width, align);
+
+    for (int link = cache.buckets[hash % RUN_BUCKETS]; link; link = cache.runs[link - 1].next) {
+        TextRun* run = &cache.runs[link - 1];
+        if (run->hash == hash && run->font == font && run->wrap_width == wrap_width &&
+            run->align == align && strcmp(run->text, text) == 0) {
+            run->refs++;
+            run->last_used = ++cache.clock;
+            return run->id;
+        }
+    }
+
+    size_t length = strlen(text);
+    char* copy = malloc(length + 1);
+    if (!copy) return 0;
+    int slot = claim_slot();
+    if (slot < 0) {
+        free(copy);
+        return 0;
+    }
+    memcpy(copy, text, length + 1);
+
+    int32_t width, height;
+    spark_graphics_measure_text(copy, font, 0, 0, wrap_width, &width, &height);
+
+    if (++cache.serial > 0xFFFF) cache.serial = 1;
+    TextRun* run = &cache.runs[slot];
+    run->id = cache.serial << 16 | (uint32_t)slot;
+    run->hash = hash;
+    run->text = copy;
+    run->font = font;
+    run->wrap_width = wrap_width;
+    run->align = align;
+    run->width = wrap_width > 0 ? wrap_width : width;
+    run->height = height;
+    run->refs = 1;
+    run->last_used = ++cache.clock;
+    run->next = cache.buckets[hash % RUN_BUCKETS];
+    cache.buckets[hash % RUN_BUCKETS] = slot + 1;
+    return run->id;
+}
+
+void spark_text_run_retain(uint32_t id) {
+    TextRun* run = find_run(id);
+    if (run) run->refs++;
+}
+
+void spark_text_run_release(uint32_t id) {
+    TextRun* run = find_run(id);
+    if (run && run->refs > 0) run->refs--;
+}
+
+bool spark_text_run_get(uint32_t id, const char** text, const lv_font_t** font, lv_text_align_t* align,
+                        int32_t* width, int32_t* height) {
+    const TextRun* run = find_run(id);
+    if (!run || !run->font) return false;
+    if (text) *text = run->text;
+    if (font) *font = run->font;
+    if (align) *align = run->align;
+    if (width) *width = run->width;
+    if (height) *height = run->height;
+    return true;
+}
+
+// Runs still referenced stop drawing, the others are recycled first.
+// Measurements are kept as slots but can't match a new font at the same address.
+void spark_text_forget_font(const lv_font_t* font) {
+    for (int i = 0; i < MEASURE_SLOTS; i++) {
+        Measurement* slot = &measures.slots[i];
+        if (slot->font != font) continue;
+        slot->font = NULL;
+        slot->last_used = 0;
+    }
+
+    for (int i = 0; i < cache.count; i++) {
+        TextRun* run = &cache.runs[i];
+        if (run->font != font) continue;
+        unlink_run(i);
+        run->font = NULL;
+        run->last_used = 0;
+    }
+}
+
+void spark_text_shutdown(void) {
+    for (int i = 0; i < MEASURE_SLOTS; i++) free(measures.slots[i].text);
+    memset(&measures, 0, sizeof(measures));
+
+    for (int i = 0; i < cache.count; i++) free(cache.runs[i].text);
+    free(cache.runs);
+    memset(&cache, 0, sizeof(cache));
+}
+
+static lv_text_align_t lvgl_text_align(SparkTextAlign align) {
     switch (align) {
-        case SPARK_TEXT_ALIGN_CENTER:
-            lv_style_set_text_align(txt->style, LV_TEXT_ALIGN_CENTER);
-            break;
-        case SPARK_TEXT_ALIGN_RIGHT:
-            lv_style_set_text_align(txt->style, LV_TEXT_ALIGN_RIGHT);
-            break;
-        default:
-            lv_style_set_text_align(txt->style, LV_TEXT_ALIGN_LEFT);
-            break;
+        case SPARK_TEXT_ALIGN_CENTER: return LV_TEXT_ALIGN_CENTER;
+        case SPARK_TEXT_ALIGN_RIGHT: return LV_TEXT_ALIGN_RIGHT;
+        default: return LV_TEXT_ALIGN_LEFT;
     }
+}
 
-    // Setup wrapping
-    lv_style_set_width(txt->style, (lv_coord_t)wrap_width);
-    
-    spark_graphics_text_draw(txt, x, y);
-    spark_graphics_text_free(txt);
+// Drawn into the current frame's draw list in the text's own color
+void spark_graphics_text_draw(SparkText* text, float x, float y) {
+    if (!text || !text->text) return;
+    lv_color_t color = lv_color_make(text->color.r, text->color.g, text->color.b);
+    spark_draw_text_run(text->text, LV_FONT_DEFAULT, x, y, 0.0f, LV_TEXT_ALIGN_LEFT, color, text->color.a);
+}
+
+// The current color and font, like the other spark_draw_* calls
+void spark_graphics_print(const char* text, float x, float y) {
+    spark_graphics_printf(text, x, y, 0.0f, SPARK_TEXT_ALIGN_LEFT);
+}
+
+void spark_graphics_printf(const char* text, float x, float y, float wrap_width, SparkTextAlign align) {
+    if (!text) return;
+    spark_draw_text_run(text, spark_font_get_current(), x, y, wrap_width, lvgl_text_align(align),
+                        spark_graphics_get_color(), spark_graphics_get_opacity());
 }
 
 void spark_graphics_text_set_color(SparkText* text, float r, float g, float b, float a) {
@@ -0,0 +1,261 @@
+// update.c
+#include "spark_graphics/primitives.h"
+#include "../internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 64
+
+enum {
+    FIELD_POS = 1 << 0,
+    FIELD_SIZE = 1 << 1,
+    FIELD_RADIUS = 1 << 2,
+    FIELD_SCALE_X = 1 << 3,
+    FIELD_ANGLES = 1 << 4
+};
+
+// Final values for one object, later updates overwrite earlier ones
+typedef struct {
+    lv_obj_t* object;       // NULL once deleted inside the transaction
+    uint8_t fields;
+    int32_t x, y, w, h;
+    int32_t radius;
+    int32_t scale_x;
+    int32_t start_angle, end_angle;
+    lv_area_t old_area;
+    bool restyled;
+} PendingUpdate;
+
+static struct {
+    int depth;
+    PendingUpdate* pending;
+    int count;
+    int capacity;
+    int* slots;             // Open addressing, object to pending index + 1, 0 is empty
+    int slot_count;         // Power of two, twice the capacity
+    int last;               // Consecutive records usually hit the same object
+} updates = { .last = -1 };
+
+static uint32_t slot_of(const lv_obj_t* object) {
+    return (uint32_t)(((uintptr_t)object >> 4) * 2654435761u) & (uint32_t)(updates.slot_count - 1);
+}
+
+static void insert_slot(int index) {
+    uint32_t slot = slot_of(updates.pending[index].object);
+    while (updates.slots[slot]) slot = (slot + 1) & (uint32_t)(updates.slot_count - 1);
+    updates.slots[slot] = index + 1;
+}
+
+static bool reserve(void) {
+    if (updates.count < updates.capacity) return true;
+
+    int capacity = updates.capacity > 0 ? updates.capacity * 2 : INITIAL_CAPACITY;
+    PendingUpdate* pending = realloc(updates.pending, sizeof(PendingUpdate) * capacity);
+    if (!pending) return false;
+    updates.pending = pending;
+
+    int* slots = calloc((size_t)capacity * 2, sizeof(int));
+    if (!slots) return false;
+    free(updates.slots);
+    updates.slots = slots;
+    updates.slot_count = capacity * 2;
+    updates.capacity = capacity;
+    for (int i = 0; i < updates.count; i++) insert_slot(i);
+    return true;
+}
+
+static PendingUpdate* find_pending(const lv_obj_t* object) {
+    if (updates.last >= 0 && updates.pending[updates.last].object == object) {
+        return &updates.pending[updates.last];
+    }
+    if (updates.slot_count == 0) return NULL;
+
+    uint32_t slot = slot_of(object);
+    while (updates.slots[slot]) {
+        int index = updates.slots[slot] - 1;
+        if (updates.pending[index].object == object) {
+            updates.last = index;
+            return &updates.pending[index];
+        }
+        slot = (slot + 1) & (uint32_t)(updates.slot_count - 1);
+    }
+    return NULL;
+}
+
+// Objects deleted before commit, by spark_graphics_clear or directly, are
+// left out. The entry stays in its slot but can no longer match.
+static void delete_event_cb(lv_event_t* e) {
+    PendingUpdate* update = find_pending(lv_event_get_current_target(e));
+    if (update) update->object = NULL;
+}
+
+// NULL outside a transaction, or for children of layout containers, whose
+// siblings move with them and need LVGL's own invalidation
+static PendingUpdate* pending_for(lv_obj_t* object) {
+    if (updates.depth == 0) return NULL;
+    PendingUpdate* found = find_pending(object);
+    if (found) return found;
+
+    lv_obj_t* parent = lv_obj_get_parent(object);
+    if (parent && lv_obj_get_style_layout(parent, LV_PART_MAIN) != LV_LAYOUT_NONE) return NULL;
+    if (!reserve()) return NULL;
+
+    int index = updates.count++;
+    PendingUpdate* update = &updates.pending[index];
+    memset(update, 0, sizeof(PendingUpdate));
+    update->object = object;
+    insert_slot(index);
+    updates.last = index;
+    lv_obj_add_event_cb(object, delete_event_cb, LV_EVENT_DELETE, NULL);
+    return update;
+}
+
+bool spark_update_record_pos(lv_obj_t* object, int32_t x, int32_t y) {
+    PendingUpdate* update = pending_for(object);
+    if (!update) return false;
+    update->fields |= FIELD_POS;
+    update->x = x;
+    update->y = y;
+    return true;
+}
+
+bool spark_update_record_size(lv_obj_t* object, int32_t w, int32_t h) {
+    PendingUpdate* update = pending_for(object);
+    if (!update) return false;
+    update->fields |= FIELD_SIZE;
+    update->w = w;
+    update->h = h;
+    return true;
+}
+
+bool spark_update_record_radius(lv_obj_t* object, int32_t radius) {
+    PendingUpdate* update = pending_for(object);
+    if (!update) return false;
+    update->fields |= FIELD_RADIUS;
+    update->radius = radius;
+    return true;
+}
+
+bool spark_update_record_scale_x(lv_obj_t* object, int32_t scale) {
+    PendingUpdate* update = pending_for(object);
+    if (!update) return false;
+    update->fields |= FIELD_SCALE_X;
+    update->scale_x = scale;
+    return true;
+}
+
+bool spark_update_record_angles(lv_obj_t* object, int32_t start, int32_t end) {
+    PendingUpdate* update = pending_for(object);
+    if (!update) return false;
+    update->fields |= FIELD_ANGLES;
+    update->start_angle = start;
+    update->end_angle = end;
+    return true;
+}
+
+// What the object covers on screen, widened for a horizontal scale
+static void get_bounds(lv_obj_t* object, lv_area_t* area) {
+    lv_obj_get_coords(object, area);
+    int32_t ext = lv_obj_get_ext_draw_size(object);
+    lv_area_increase(area, ext, ext);
+
+    int32_t scale = lv_obj_get_style_transform_scale_x(object, LV_PART_MAIN);
+    if (scale > 256) {
+        int32_t grow = lv_area_get_width(area) * (scale - 256) / 256;
+        lv_area_increase(area, grow, 0);
+    }
+}
+
+static bool is_restyled(const PendingUpdate* update) {
+    lv_obj_t* object = update->object;
+    if ((update->fields & FIELD_RADIUS) &&
+        lv_obj_get_style_radius(object, LV_PART_MAIN) != update->radius) return true;
+    if ((update->fields & FIELD_SCALE_X) &&
+        lv_obj_get_style_transform_scale_x(object, LV_PART_MAIN) != update->scale_x) return true;
+    if ((update->fields & FIELD_ANGLES) &&
+        ((int32_t)lv_arc_get_angle_start(object) != update->start_angle ||
+         (int32_t)lv_arc_get_angle_end(object) != update->end_angle)) return true;
+    return false;
+}
+
+static void apply(const PendingUpdate* update) {
+    lv_obj_t* object = update->object;
+    if (update->fields & FIELD_POS) lv_obj_set_pos(object, update->x, update->y);
+    if (update->fields & FIELD_SIZE) lv_obj_set_size(object, update->w, update->h);
+    if (update->fields & FIELD_RADIUS) lv_obj_set_style_radius(object, update->radius, 0);
+    if (update->fields & FIELD_SCALE_X) lv_obj_set_style_transform_scale_x(object, update->scale_x, 0);
+    if (update->fields & FIELD_ANGLES) lv_arc_set_angles(object, update->start_angle, update->end_angle);
+}
+
+// LVGL would invalidate each setter and both ends of every layout move.
+// Instead invalidation is off while everything is applied and laid out
+// once, then each object invalidates its old and new bounds together.
+static void apply_all(void) {
+    lv_obj_t* any = NULL;
+    for (int i = 0; i < updates.count && !any; i++) any = updates.pending[i].object;
+    if (!any) return;
+    lv_display_t* display = lv_obj_get_display(any);
+
+    // Layout left over from earlier calls still invalidates normally
+    lv_obj_update_layout(any);
+
+    for (int i = 0; i < updates.count; i++) {
+        PendingUpdate* update = &updates.pending[i];
+        if (!update->object) continue;
+        get_bounds(update->object, &update->old_area);
+        update->restyled = is_restyled(update);
+    }
+
+    lv_display_enable_invalidation(display, false);
+    for (int i = 0; i < updates.count; i++) {
+        if (updates.pending[i].object) apply(&updates.pending[i]);
+    }
+    lv_obj_update_layout(any);
+    lv_display_enable_invalidation(display, true);
+
+    for (int i = 0; i < updates.count; i++) {
+        const PendingUpdate* update = &updates.pending[i];
+        if (!update->object) continue;
+        lv_area_t area;
+        get_bounds(update->object, &area);
+        if (!update->restyled && memcmp(&area, &update->old_area, sizeof(lv_area_t)) == 0) continue;
+
+        SparkTraceScope scope = spark_debug_trace_begin("spark_graphics_commit_update", update->object);
+        if (lv_area_is_on(&area, &update->old_area)) {
+            lv_area_join(&area, &area, &update->old_area);
+            lv_inv_area(display, &area);
+        } else {
+            lv_inv_area(display, &update->old_area);
+            lv_inv_area(display, &area);
+        }
+        spark_debug_trace_end(&scope);
+    }
+}
+
+void spark_graphics_begin_update(void) {
+    updates.depth++;
+}
+
+void spark_graphics_commit_update(void) {
+    if (updates.depth == 0) {
+        fprintf(stderr, "spark_graphics_commit_update without begin\n");
+        return;
+    }
+    if (--updates.depth > 0) return;
+
+    if (updates.count > 0) apply_all();
+    for (int i = 0; i < updates.count; i++) {
+        if (updates.pending[i].object) lv_obj_remove_event_cb(updates.pending[i].object, delete_event_cb);
+    }
+    updates.count = 0;
+    updates.last = -1;
+    if (updates.slots) memset(updates.slots, 0, sizeof(int) * updates.slot_count);
+}
+
+void spark_update_end_frame(void) {
+    if (updates.depth == 0) return;
+    fprintf(stderr, "spark_graphics_begin_update without commit, committing at end of update\n");
+    updates.depth = 1;
+    spark_graphics_commit_update();
+}
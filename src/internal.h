@@ -3,9 +3,11 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_rect.h>
+#include <stdarg.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "lvgl.h"
+#include "../include/spark2d.h"
 #include "../include/spark_window.h"
 #include "spark_ui/container.h"
 
@@ -15,7 +17,7 @@ typedef struct {
     WindowState window_state;
     lv_display_t* display;
     lv_indev_t* mouse_indev;
-    lv_layer_t* draw_layer;
+    lv_layer_t* draw_layer;             // Layer a draw list is rendering into, NULL outside
     void (*load)(void);
     void (*update)(float dt);
     void (*draw)(void);
@@ -24,8 +26,161 @@ typedef struct {
     bool fullscreen;
     bool maximize;
     SparkContainer* current_container;  // Current UI container context
+    SparkBackend backend;
+    unsigned long max_frames;
+    unsigned long frame_count;
 } Spark2D;
 
 extern Spark2D spark;
 
+// Frame pacer (spark_timer.c)
+void spark_timer_init(void);
+void spark_timer_reset(void);
+int spark_timer_begin_frame(float* step);
+void spark_timer_end_frame(void);
+void spark_timer_set_virtual_clock(double step);  // 0 returns to the real clock
+double spark_timer_get_virtual_time(void);
+uint32_t spark_timer_get_ticks(void);             // LVGL tick source, follows the virtual clock
+
+// Frame phase timing (spark_stats.c)
+void spark_stats_attach_display(lv_display_t* display);
+void spark_stats_begin_frame(void);
+void spark_stats_add(SparkStatsPhase phase, double seconds);
+void spark_stats_add_timer_handler(double seconds);
+void spark_stats_end_frame(void);
+
+// Draw unit selection (spark_threads.c)
+void spark_threads_init(void);
+void spark_threads_deinit(void);
+
+// Display buffers and flush (spark_render.c). pixels points at the area's
+// top-left pixel; last is set on the final flush of a refresh.
+typedef void (*SparkRenderFlush)(const lv_area_t* area, const uint8_t* pixels,
+                                 uint32_t stride, bool last);
+bool spark_render_init(lv_display_t* display, SparkRenderFlush flush, uint8_t* framebuffer);
+void spark_render_shutdown(void);
+
+// SDL window backend (spark_sdl.c)
+bool spark_sdl_init(const char* title, int width, int height);
+void spark_sdl_handle_event(const SDL_Event* event);
+void spark_sdl_present(void);
+void spark_sdl_shutdown(void);
+
+// Invalidation tracking (spark_debug.c). SPARK_TRACE_INVALIDATION(obj) at
+// the top of a public call attributes what it invalidates until it returns.
+typedef struct {
+    bool active;
+} SparkTraceScope;
+
+#define SPARK_TRACE_INVALIDATION(obj) \
+    SparkTraceScope spark_trace_scope __attribute__((cleanup(spark_debug_trace_end))) = \
+        spark_debug_trace_begin(__func__, (obj))
+
+SparkTraceScope spark_debug_trace_begin(const char* function, lv_obj_t* object);
+void spark_debug_trace_end(SparkTraceScope* scope);
+void spark_debug_attach_display(lv_display_t* display);
+void spark_debug_end_frame(void);
+bool spark_debug_is_animating(void);
+void spark_debug_draw_overlay(SDL_Renderer* renderer);
+
+// Label text updates (ui/label.c). Formats into the label's spare buffer
+// and applies it only if it differs; false when unchanged or out of memory.
+bool spark_label_text_vset(lv_obj_t* label, SparkLabelText* text, const char* function,
+                           const char* format, va_list args);
+bool spark_label_text_set(lv_obj_t* label, SparkLabelText* text, const char* function, const char* string);
+void spark_label_text_free(SparkLabelText* text);
+
+// Headless display backend (spark_headless.c)
+bool spark_headless_init(int width, int height);
+void spark_headless_shutdown(void);
+
+// Image decoding (graphics/image.c)
+uint32_t* spark_image_decode_argb8888(const void* src, int32_t* width, int32_t* height);
+
+// Objects showing an owned ARGB8888 image (graphics/image_object.c), at x, y
+// on the current layer. The owner keeps the pixels alive; prepare, if set,
+// brings them up to date from the draw event once per change. object is
+// cleared when LVGL deletes it. Strides are in pixels.
+typedef struct SparkImageObject {
+    lv_obj_t* object;
+    lv_image_dsc_t image;
+    bool changed;           // Pixels changed since the last draw
+    void (*prepare)(void* owner);
+    void* owner;
+} SparkImageObject;
+
+bool spark_image_object_create(SparkImageObject* view, float x, float y,
+                               void (*prepare)(void* owner), void* owner);
+void spark_image_object_set_pixels(SparkImageObject* view, const uint32_t* pixels, int32_t w, int32_t h,
+                                   int32_t stride);
+void spark_image_object_changed(SparkImageObject* view);    // Also invalidates the object
+void spark_image_object_free(SparkImageObject* view);
+
+// Filled polygon objects (graphics/polygon.c), vertices are parent-relative x, y pairs
+lv_obj_t* spark_polygon_create(lv_obj_t* parent, const float* vertices, int count);
+void spark_polygon_update(lv_obj_t* obj, const float* vertices, int count);
+
+// Polyline objects (graphics/polyline.c), also used for lines and polygon outlines
+#define SPARK_POLYLINE_FLAG LV_OBJ_FLAG_USER_1
+lv_obj_t* spark_polyline_create(lv_obj_t* parent, const float* vertices, int count, bool closed);
+void spark_polyline_update(lv_obj_t* obj, const float* vertices, int count);
+void spark_polyline_set_width(lv_obj_t* obj, int32_t width);
+
+// Graphics state (graphics/core.c). begin_frame resets the transform stack.
+void spark_graphics_begin_frame(void);
+bool spark_transform_is_identity(const SparkTransform* t);
+void spark_transform_apply(const SparkTransform* t, const float* xy, float* out, int count);
+// Blend mode for shapes LVGL draws, warning once per mode it can't blend
+lv_blend_mode_t spark_blend_mode_to_lvgl(SparkBlendMode mode);
+
+// Update transactions (graphics/update.c). While one is open the record
+// calls buffer the change and return true, otherwise the caller applies it.
+bool spark_update_record_pos(lv_obj_t* object, int32_t x, int32_t y);
+bool spark_update_record_size(lv_obj_t* object, int32_t w, int32_t h);
+bool spark_update_record_radius(lv_obj_t* object, int32_t radius);
+bool spark_update_record_scale_x(lv_obj_t* object, int32_t scale);
+bool spark_update_record_angles(lv_obj_t* object, int32_t start, int32_t end);
+void spark_update_end_frame(void);  // Commits a transaction left open by update
+
+// Draw lists (graphics/draw.c)
+void spark_draw_frame(void (*callback)(void));
+void spark_draw_shutdown(void);
+int spark_draw_text_run(const char* text, const lv_font_t* font, float x, float y, float wrap_width,
+                        lv_text_align_t align, lv_color_t color, lv_opa_t opa);
+
+// Cached text runs (graphics/text.c). acquire returns a referenced run id,
+// 0 on failure; a run is only recycled once nothing references it.
+uint32_t spark_text_run_acquire(const char* text, const lv_font_t* font, int32_t wrap_width,
+                                lv_text_align_t align);
+void spark_text_run_retain(uint32_t id);
+void spark_text_run_release(uint32_t id);
+bool spark_text_run_get(uint32_t id, const char** text, const lv_font_t** font, lv_text_align_t* align,
+                        int32_t* width, int32_t* height);
+void spark_text_forget_font(const lv_font_t* font);
+void spark_text_measure_get_counts(unsigned long* hits, unsigned long* misses);
+void spark_text_measure_reset_counts(void);
+void spark_text_shutdown(void);
+
+// Fonts (graphics/font.c)
+const lv_font_t* spark_font_get_current(void);  // LV_FONT_DEFAULT when none is set
+
+// Event queue (spark_event.c). queue_input copies data and is not recorded.
+bool spark_event_has_pending(void);
+bool spark_event_queue_input(SparkEventType type, const void* data, size_t data_size);
+
+// Keyboard (spark_keyboard.c), scancodes are SparkScancode values
+int spark_keyboard_from_sdl(SDL_Scancode scancode);
+void spark_keyboard_set_replay_key(int scancode, bool down);
+void spark_keyboard_clear_replay_keys(void);
+
+// Input record/replay (spark_replay.c)
+bool spark_replay_begin_frame(void);  // Delivers due input, true when a quit_at_end replay ends
+bool spark_replay_read_pointer(lv_indev_data_t* data);  // false when not replaying
+void spark_replay_record_pointer(int32_t x, int32_t y, bool pressed);
+void spark_replay_record_key(int scancode, bool down);
+void spark_replay_record_wheel(float x, float y);
+void spark_replay_record_resize(int width, int height);
+void spark_replay_record_event(SparkEventType type, const void* data, size_t size);
+void spark_replay_shutdown(void);
+
 #endif
\ No newline at end of file
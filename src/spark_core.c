@@ -3,7 +3,11 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include "src/display/lv_display_private.h"
+#include "src/misc/lv_timer_private.h"
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
@@ -12,23 +16,112 @@
 Spark2D spark = {0};
 static bool should_quit = false;
 
+#define MAX_POLL_TIMERS 16
+
+static struct {
+    bool enabled;
+    bool update_continuous;
+    uint32_t wake_event;
+    int wake_pending;
+    // Timers that exist right after init (display refresh, indev read,
+    // SDL event pump) poll forever and must not keep the loop awake
+    lv_timer_t* poll_timers[MAX_POLL_TIMERS];
+    int poll_timer_count;
+} idle = {
+    .update_continuous = true
+};
+
 static void spark_configure(void) {
     spark.window_state.base_width = atoi(getenv("SPARK_WINDOW_WIDTH") ?: "800");
     spark.window_state.base_height = atoi(getenv("SPARK_WINDOW_HEIGHT") ?: "480");
+
+    // Environment overrides whatever was set before spark_init
+    const char* idle_mode = getenv("SPARK_IDLE_MODE");
+    if (idle_mode) {
+        idle.enabled = atoi(idle_mode) != 0;
+    }
+
+    const char* max_frames = getenv("SPARK_MAX_FRAMES");
+    if (max_frames) {
+        spark.max_frames = strtoul(max_frames, NULL, 10);
+    }
+
+    const char* backend = getenv("SPARK_BACKEND");
+    if (backend && strcmp(backend, "headless") == 0) {
+        spark.backend = SPARK_BACKEND_HEADLESS;
+    } else if (backend && strcmp(backend, "sdl") == 0) {
+        spark.backend = SPARK_BACKEND_SDL;
+    }
+
+    const char* target_fps = getenv("SPARK_TARGET_FPS");
+    if (target_fps) {
+        spark_timer_set_target_fps((float)atof(target_fps));
+    }
+
+    const char* render_mode = getenv("SPARK_RENDER_MODE");
+    const char* render_band = getenv("SPARK_RENDER_BAND");
+    if (render_mode || render_band) {
+        SparkRenderMode mode = spark_get_render_mode();
+        if (render_mode && strcmp(render_mode, "direct") == 0) {
+            mode = SPARK_RENDER_DIRECT;
+        } else if (render_mode && strcmp(render_mode, "partial") == 0) {
+            mode = SPARK_RENDER_PARTIAL;
+        } else if (render_mode && strcmp(render_mode, "full") == 0) {
+            mode = SPARK_RENDER_FULL;
+        }
+        spark_set_render_mode(mode, atoi(render_band ?: "0"));
+    }
+
+    const char* debug_dirty = getenv("SPARK_DEBUG_DIRTY");
+    if (debug_dirty && atoi(debug_dirty) != 0) {
+        spark_debug_set_dirty_overlay(true);
+    }
+
+    const char* draw_units = getenv("SPARK_DRAW_UNITS");
+    if (draw_units) {
+        spark_set_draw_units(atoi(draw_units));
+    }
 }
 
-#if LV_USE_SDL
-static void init_mouse(lv_display_t* disp) {
-    lv_indev_t* mouse_indev = lv_sdl_mouse_create();
-    lv_indev_set_display(mouse_indev, disp);
+// Needs the display, so it runs at the end of spark_init
+static void configure_replay(void) {
+    const char* replay = getenv("SPARK_REPLAY");
+    if (replay) {
+        spark_replay_start(replay, (float)atof(getenv("SPARK_REPLAY_STEP") ?: "0"), true);
+        return;
+    }
+
+    const char* record = getenv("SPARK_RECORD");
+    if (record) {
+        spark_replay_start_recording(record);
+    }
 }
+
+static bool init_sdl(const char* title, int width, int height) {
+#if LV_USE_SDL
+    if (!spark_sdl_init(title, width, height)) {
+        return false;
+    }
+
+    idle.wake_event = SDL_RegisterEvents(1);
+    return true;
+#else
+    fprintf(stderr, "Spark2D was built without SDL support\n");
+    return false;
 #endif
+}
+
+void spark_set_backend(SparkBackend backend) {
+    spark.backend = backend;
+}
+
 bool spark_init(const char* title, int width, int height) {
     if (width <= 0 || height <= 0 || !title) {
         fprintf(stderr, "Invalid parameters for spark_init\n");
         return false;
     }
 
+    spark_timer_init();
     spark_configure();
     if (width > 0 && height > 0) {
         spark.window_state.base_width = width;
@@ -47,76 +140,234 @@ bool spark_init(const char* title, int width, int height) {
 
     // Initialize LVGL first
     lv_init();
+    spark_threads_init();
 
-#if LV_USE_SDL
-    // Initialize SDL
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        fprintf(stderr, "SDL initialization failed: %s\n", SDL_GetError());
+    if (spark.backend == SPARK_BACKEND_HEADLESS) {
+        if (!spark_headless_init(width, height)) {
+            fprintf(stderr, "Headless display creation failed\n");
+            return false;
+        }
+    } else if (!init_sdl(title, width, height)) {
         return false;
     }
 
-    // Create LVGL display
-    lv_display_t* display = lv_sdl_window_create(width, height);
-    if (!display) {
-        fprintf(stderr, "LVGL display creation failed\n");
-        return false;
+    spark_stats_attach_display(spark.display);
+    spark_debug_attach_display(spark.display);
+    lv_obj_set_style_bg_opa(lv_screen_active(), LV_OPA_TRANSP, LV_PART_MAIN);
+
+    idle.poll_timer_count = 0;
+    for (lv_timer_t* t = lv_timer_get_next(NULL);
+         t && idle.poll_timer_count < MAX_POLL_TIMERS;
+         t = lv_timer_get_next(t)) {
+        idle.poll_timers[idle.poll_timer_count++] = t;
     }
 
-    // Set the window title using LVGL's function
-    lv_sdl_window_set_title(display, title);
+    configure_replay();
+    return true;
+}
 
-    spark.display = display;
+static bool is_poll_timer(lv_timer_t* timer) {
+    for (int i = 0; i < idle.poll_timer_count; i++) {
+        if (idle.poll_timers[i] == timer) return true;
+    }
+    return false;
+}
 
-    // Configure LVGL display
-    lv_display_set_color_format(display, LV_COLOR_FORMAT_ARGB8888);
-    lv_obj_set_style_bg_opa(lv_screen_active(), LV_OPA_TRANSP, LV_PART_MAIN);
+static bool loop_is_idle(void) {
+    // Nothing but the app itself can wake a headless run
+    if (spark.backend == SPARK_BACKEND_HEADLESS) return false;
+    if ((spark.update || spark.draw) && idle.update_continuous) return false;
+    if (lv_anim_count_running() > 0) return false;
+    if (spark.display && spark.display->inv_p > 0) return false;
+    if (spark_event_has_pending()) return false;
+    if (spark_debug_is_animating()) return false;
+    if (spark_replay_is_playing()) return false;
+    return true;
+}
 
-    // Initialize mouse input
-    init_mouse(display);
-#endif
+// Milliseconds until the next non-polling LVGL timer fires, -1 if none
+static int next_timer_deadline(void) {
+    int deadline = -1;
+    for (lv_timer_t* t = lv_timer_get_next(NULL); t; t = lv_timer_get_next(t)) {
+        if (t->paused || is_poll_timer(t)) continue;
 
-    return true;
+        uint32_t elapsed = lv_tick_elaps(t->last_run);
+        int remaining = elapsed >= t->period ? 0 : (int)(t->period - elapsed);
+        if (deadline < 0 || remaining < deadline) {
+            deadline = remaining;
+        }
+    }
+    return deadline;
+}
+
+static void wait_for_wakeup(void) {
+    int timeout = next_timer_deadline();
+    if (timeout == 0) return;
+
+    #if LV_USE_SDL
+    // Peek only: the next iteration's poll loop consumes the event
+    SDL_WaitEventTimeout(NULL, timeout);
+    #endif
+    __atomic_store_n(&idle.wake_pending, 0, __ATOMIC_RELEASE);
+
+    // Idle time is not frame time
+    spark_timer_reset();
+}
+
+void spark_set_idle_mode(bool enabled) {
+    idle.enabled = enabled;
+}
+
+void spark_set_update_continuous(bool continuous) {
+    idle.update_continuous = continuous;
+}
+
+void spark_wake(void) {
+    if (!idle.enabled) return;
+    if (__atomic_exchange_n(&idle.wake_pending, 1, __ATOMIC_ACQ_REL)) return;
+
+    #if LV_USE_SDL
+    SDL_Event event = {0};
+    event.type = idle.wake_event;
+    SDL_PushEvent(&event);
+    #endif
 }
 
 
 static void main_loop_iteration(void) {
-    uint32_t idle = lv_timer_handler();
-    
+    float step;
+    int steps = spark_timer_begin_frame(&step);
+    spark_stats_begin_frame();
+    double phase_start = spark_timer_get_time();
+
     #if LV_USE_SDL
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        if (event.type == SDL_QUIT) {
-            should_quit = true;
-            break;
+    if (spark.backend == SPARK_BACKEND_SDL) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT) {
+                should_quit = true;
+                break;
+            }
+            spark_sdl_handle_event(&event);
         }
     }
     #endif
 
-    if (spark.update) {
-        spark.update(1.0f / 60.0f);
+    if (spark_replay_begin_frame()) {
+        should_quit = true;
     }
 
-    usleep(idle * 1000);
+    double now = spark_timer_get_time();
+    spark_stats_add(SPARK_STATS_PHASE_EVENTS, now - phase_start);
+    phase_start = now;
+
+    if (spark.update || spark.draw) {
+        spark_lock();
+        for (int i = 0; spark.update && i < steps; i++) {
+            spark.update(step);
+        }
+        spark_update_end_frame();
+        if (spark.draw) {
+            spark_draw_frame(spark.draw);
+        }
+        spark_unlock();
+    }
+
+    now = spark_timer_get_time();
+    spark_stats_add(SPARK_STATS_PHASE_UPDATE, now - phase_start);
+    phase_start = now;
+
+    // Layout, render and flush are split out by the display event hooks
+    lv_timer_handler();
+    now = spark_timer_get_time();
+    spark_stats_add_timer_handler(now - phase_start);
+    spark_debug_end_frame();
+    phase_start = spark_timer_get_time();
+
+    spark.frame_count++;
+    if (spark.max_frames > 0 && spark.frame_count >= spark.max_frames) {
+        spark_stats_end_frame();
+        should_quit = true;
+        return;
+    }
+
+    if (idle.enabled && loop_is_idle()) {
+        wait_for_wakeup();
+    } else {
+        spark_timer_end_frame();
+    }
+
+    spark_stats_add(SPARK_STATS_PHASE_SLEEP, spark_timer_get_time() - phase_start);
+    spark_stats_end_frame();
 }
 
 void spark_set_load(void (*load)(void)) { spark.load = load; }
 void spark_set_update(void (*update)(float dt)) { spark.update = update; }
 void spark_set_draw(void (*draw)(void)) { spark.draw = draw; }
+void spark_set_max_frames(unsigned long frames) { spark.max_frames = frames; }
+unsigned long spark_get_frame_count(void) { return spark.frame_count; }
+
+static void print_run_report(double seconds) {
+    printf("Spark2D: %lu frames in %.2f s (%.1f fps)\n",
+           spark.frame_count, seconds, seconds > 0.0 ? spark.frame_count / seconds : 0.0);
+
+    SparkRenderStats render;
+    spark_render_get_stats(&render);
+    printf("Spark2D: %lu rendered, avg %.0f px, %.0f flush bytes, %.1f areas merged, %zu byte buffer\n",
+           render.frames,
+           (double)render.avg_rendered_pixels,
+           (double)render.avg_flush_bytes,
+           (double)render.avg_areas_merged,
+           render.buffer_bytes);
+
+    SparkStats stats;
+    if (!spark_stats_get(&stats)) return;
+
+    printf("Spark2D: last %d frames, ms    p50      p95      p99      max\n", stats.samples);
+    for (int phase = 0; phase < SPARK_STATS_PHASE_COUNT; phase++) {
+        const SparkStatsPhaseSummary* p = &stats.phases[phase];
+        printf("Spark2D:   %-8s %8.3f %8.3f %8.3f %8.3f\n",
+               spark_stats_phase_name((SparkStatsPhase)phase),
+               (double)p->p50, (double)p->p95, (double)p->p99, (double)p->max);
+    }
+    printf("Spark2D: text measurements %lu hits, %lu misses (%.1f%% hit rate)\n",
+           stats.text_measure_hits, stats.text_measure_misses, (double)(stats.text_measure_hit_rate * 100.0f));
+}
 
 int spark_run(void) {
     if (spark.load) {
+        spark_lock();
         spark.load();
+        spark_unlock();
     }
+
+    // Don't count load time as the first frame's dt
+    spark_timer_reset();
+    double start = spark_timer_get_time();
     
     while (!should_quit) {
         main_loop_iteration();
     }
+
+    // Unattended runs report how long the frames took
+    if (spark.max_frames > 0 || spark.backend == SPARK_BACKEND_HEADLESS) {
+        print_run_report(spark_timer_get_time() - start);
+    }
     return 0;
 }
 
 void spark_quit(void) {
+    spark_replay_shutdown();
+    spark_stats_stop_exporter();
+    spark_threads_deinit();
+    spark_draw_shutdown();
+    spark_text_shutdown();
     lv_deinit();
+    if (spark.backend == SPARK_BACKEND_HEADLESS) {
+        spark_headless_shutdown();
+        return;
+    }
     #if LV_USE_SDL
-    SDL_Quit();
+    spark_sdl_shutdown();
     #endif
 }
\ No newline at end of file
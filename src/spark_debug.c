@@ -0,0 +1,261 @@
+// spark_debug.c
+#include "spark_debug.h"
+#include "spark_timer.h"
+#include "internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_TOUCHED 128
+#define MAX_OVERLAY_AREAS 256
+#define OVERLAY_FADE_TIME 0.5
+
+// Objects Spark calls changed this frame. LVGL moves and resizes them
+// during the next layout pass, outside any traced call, so those
+// invalidations are matched back by area.
+typedef struct {
+    const char* function;
+    lv_obj_t* object;
+    lv_area_t coords;
+} TouchedObject;
+
+typedef struct {
+    lv_area_t area;
+    double time;
+    uint32_t color;
+} OverlayArea;
+
+static const uint32_t overlay_colors[] = {
+    0xFF4040, 0x40FF40, 0x4080FF, 0xFFC040, 0xFF40FF, 0x40FFFF, 0xFF8040, 0xC0FF40
+};
+
+static struct {
+    bool tracking;
+    bool overlay;
+    bool rendered;
+
+    // Innermost traced call, outer calls win so helpers report their caller
+    const char* function;
+    lv_obj_t* object;
+
+    TouchedObject touched[MAX_TOUCHED];
+    int touched_count;
+
+    SparkInvalidationReport current;
+    SparkInvalidationReport report;
+    bool has_report;
+
+    OverlayArea overlay_areas[MAX_OVERLAY_AREAS];
+    int overlay_next;
+    double overlay_last;
+} debug = {0};
+
+void spark_debug_set_invalidation_tracking(bool enabled) {
+    debug.tracking = enabled || debug.overlay;
+}
+
+void spark_debug_set_dirty_overlay(bool enabled) {
+    debug.overlay = enabled;
+    if (enabled) debug.tracking = true;
+}
+
+SparkTraceScope spark_debug_trace_begin(const char* function, lv_obj_t* object) {
+    SparkTraceScope scope = { .active = false };
+    if (!debug.tracking || debug.function) return scope;
+
+    debug.function = function;
+    debug.object = object;
+    scope.active = true;
+
+    if (object && debug.touched_count < MAX_TOUCHED) {
+        TouchedObject* touched = &debug.touched[debug.touched_count++];
+        touched->function = function;
+        touched->object = object;
+        lv_obj_get_coords(object, &touched->coords);
+    }
+    return scope;
+}
+
+void spark_debug_trace_end(SparkTraceScope* scope) {
+    if (!scope->active) return;
+    debug.function = NULL;
+    debug.object = NULL;
+}
+
+static void attribute(const lv_area_t* area, const char** function, lv_obj_t** object) {
+    if (debug.function) {
+        *function = debug.function;
+        *object = debug.object;
+        return;
+    }
+
+    // Latest change first
+    for (int i = debug.touched_count - 1; i >= 0; i--) {
+        TouchedObject* touched = &debug.touched[i];
+        if (!lv_obj_is_valid(touched->object)) continue;
+
+        lv_area_t coords;
+        lv_obj_get_coords(touched->object, &coords);
+        if (lv_area_is_on(area, &touched->coords) || lv_area_is_on(area, &coords)) {
+            *function = touched->function;
+            *object = touched->object;
+            return;
+        }
+    }
+
+    *function = "lvgl";
+    *object = NULL;
+}
+
+static uint32_t color_for(const char* function) {
+    uint32_t hash = 5381;
+    for (const char* c = function; *c; c++) {
+        hash = hash * 33 + (uint8_t)*c;
+    }
+    return overlay_colors[hash % (sizeof(overlay_colors) / sizeof(overlay_colors[0]))];
+}
+
+static void record(const lv_area_t* area) {
+    const char* function;
+    lv_obj_t* object;
+    attribute(area, &function, &object);
+
+    uint64_t pixels = lv_area_get_size(area);
+    SparkInvalidationReport* report = &debug.current;
+    report->areas++;
+    report->pixels += pixels;
+
+    SparkInvalidationSource* source = NULL;
+    for (int i = 0; i < report->source_count; i++) {
+        if (report->sources[i].function == function && report->sources[i].object == object) {
+            source = &report->sources[i];
+            break;
+        }
+    }
+    if (!source) {
+        // Out of slots: fold into the last one rather than dropping the pixels
+        int index = report->source_count < SPARK_DEBUG_MAX_SOURCES
+            ? report->source_count++ : SPARK_DEBUG_MAX_SOURCES - 1;
+        source = &report->sources[index];
+        if (index == SPARK_DEBUG_MAX_SOURCES - 1 && source->function) {
+            source->function = "other";
+            source->object = NULL;
+        } else {
+            source->function = function;
+            source->object = object;
+        }
+    }
+    source->areas++;
+    source->pixels += pixels;
+
+    if (debug.overlay) {
+        OverlayArea* overlay = &debug.overlay_areas[debug.overlay_next];
+        debug.overlay_next = (debug.overlay_next + 1) % MAX_OVERLAY_AREAS;
+        overlay->area = *area;
+        overlay->time = spark_timer_get_time();
+        overlay->color = color_for(function);
+        debug.overlay_last = overlay->time;
+    }
+}
+
+static void display_event_cb(lv_event_t* e) {
+    if (!debug.tracking) return;
+
+    if (lv_event_get_code(e) == LV_EVENT_INVALIDATE_AREA) {
+        record(lv_event_get_param(e));
+    } else {
+        debug.rendered = true;
+    }
+}
+
+void spark_debug_attach_display(lv_display_t* display) {
+    lv_display_add_event_cb(display, display_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_display_add_event_cb(display, display_event_cb, LV_EVENT_RENDER_START, NULL);
+}
+
+static int compare_sources(const void* a, const void* b) {
+    uint64_t pa = ((const SparkInvalidationSource*)a)->pixels;
+    uint64_t pb = ((const SparkInvalidationSource*)b)->pixels;
+    return (pa < pb) - (pa > pb);
+}
+
+bool spark_debug_is_animating(void) {
+    return debug.overlay && spark_timer_get_time() - debug.overlay_last < OVERLAY_FADE_TIME;
+}
+
+void spark_debug_end_frame(void) {
+    if (!debug.tracking) return;
+
+    // Invalidations pile up until the display timer actually renders them
+    if (debug.rendered) {
+        debug.current.frame = spark.frame_count;
+        qsort(debug.current.sources, debug.current.source_count,
+              sizeof(SparkInvalidationSource), compare_sources);
+        debug.report = debug.current;
+        debug.has_report = true;
+
+        memset(&debug.current, 0, sizeof(debug.current));
+        debug.touched_count = 0;
+        debug.rendered = false;
+        return;
+    }
+
+    // Keep fading the overlay while nothing else redraws
+    #if LV_USE_SDL
+    if (spark.backend == SPARK_BACKEND_SDL && spark_debug_is_animating()) {
+        spark_sdl_present();
+    }
+    #endif
+}
+
+#if LV_USE_SDL
+void spark_debug_draw_overlay(SDL_Renderer* renderer) {
+    if (!debug.overlay) return;
+
+    double now = spark_timer_get_time();
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    for (int i = 0; i < MAX_OVERLAY_AREAS; i++) {
+        OverlayArea* overlay = &debug.overlay_areas[i];
+        double age = now - overlay->time;
+        if (overlay->time <= 0.0 || age >= OVERLAY_FADE_TIME) continue;
+
+        float fade = (float)(1.0 - age / OVERLAY_FADE_TIME);
+        SDL_Rect rect = {
+            overlay->area.x1, overlay->area.y1,
+            lv_area_get_width(&overlay->area), lv_area_get_height(&overlay->area)
+        };
+        Uint8 r = (overlay->color >> 16) & 0xFF;
+        Uint8 g = (overlay->color >> 8) & 0xFF;
+        Uint8 b = overlay->color & 0xFF;
+
+        SDL_SetRenderDrawColor(renderer, r, g, b, (Uint8)(64.0f * fade));
+        SDL_RenderFillRect(renderer, &rect);
+        SDL_SetRenderDrawColor(renderer, r, g, b, (Uint8)(224.0f * fade));
+        SDL_RenderDrawRect(renderer, &rect);
+    }
+}
+#endif
+
+bool spark_debug_get_invalidation_report(SparkInvalidationReport* report) {
+    if (!report || !debug.has_report) return false;
+    *report = debug.report;
+    return true;
+}
+
+void spark_debug_print_invalidation_report(void) {
+    if (!debug.has_report) {
+        printf("No invalidations recorded\n");
+        return;
+    }
+
+    const SparkInvalidationReport* report = &debug.report;
+    printf("Frame %lu: %u areas, %llu px invalidated\n",
+           report->frame, report->areas, (unsigned long long)report->pixels);
+    for (int i = 0; i < report->source_count; i++) {
+        const SparkInvalidationSource* source = &report->sources[i];
+        printf("  %10llu px  %4u areas  %s (%p)\n",
+               (unsigned long long)source->pixels, source->areas,
+               source->function, (void*)source->object);
+    }
+}
@@ -1,4 +1,5 @@
 #include "spark_event.h"
+#include "spark2d.h"
 #include "internal.h"
 #include <stdlib.h>
 #include <string.h>
@@ -130,13 +131,16 @@ void spark_event_clear(void) {
 }
 
 bool spark_event_poll(SparkEvent* out_event) {
+    spark_lock();
     if (event_system.size == 0) {
+        spark_unlock();
         return false;
     }
 
     *out_event = event_system.events[event_system.head];
     event_system.head = (event_system.head + 1) % MAX_EVENT_QUEUE_SIZE;
     event_system.size--;
+    spark_unlock();
     return true;
 }
 
@@ -148,7 +152,11 @@ bool spark_event_wait(SparkEvent* out_event) {
     return spark_event_poll(out_event);
 }
 
-bool spark_event_push(SparkEventType type, void* data, size_t data_size) {
+bool spark_event_has_pending(void) {
+    return event_system.size > 0;
+}
+
+bool spark_event_queue_input(SparkEventType type, const void* data, size_t data_size) {
     SparkEvent event = {
         .type = type,
         .data = NULL,
@@ -161,7 +169,26 @@ bool spark_event_push(SparkEventType type, void* data, size_t data_size) {
         memcpy(event.data, data, data_size);
     }
     
-    return queue_event(&event);
+    // May be called from any thread
+    spark_lock();
+    bool queued = queue_event(&event);
+    spark_unlock();
+
+    if (!queued) {
+        free(event.data);
+        return false;
+    }
+    spark_wake();
+    return true;
+}
+
+bool spark_event_push(SparkEventType type, void* data, size_t data_size) {
+    // A replay delivers the pushes it recorded instead
+    if (spark_replay_is_playing()) return true;
+
+    if (!spark_event_queue_input(type, data, data_size)) return false;
+    spark_replay_record_event(type, data, data_size);
+    return true;
 }
 
 bool spark_event_add_handler(SparkEventType type, SparkEventHandler handler) {
@@ -0,0 +1,170 @@
+// spark_headless.c
+#include "spark_headless.h"
+#include "spark_timer.h"
+#include "internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POINTER_QUEUE_SIZE 64
+
+typedef struct {
+    int32_t x;
+    int32_t y;
+    bool pressed;
+} PointerState;
+
+static struct {
+    uint8_t* framebuffer;
+    int width;
+    int height;
+    uint32_t stride;
+    SparkHeadlessFlushCallback flush_cb;
+    void* flush_user_data;
+
+    // Pending pointer states, so a press and release queued in the same
+    // frame still reach LVGL as two separate reads
+    PointerState pointer;
+    PointerState queue[POINTER_QUEUE_SIZE];
+    int queue_head;
+    int queue_size;
+} headless = {0};
+
+static void flush(const lv_area_t* area, const uint8_t* pixels, uint32_t stride, bool last) {
+    uint32_t w = lv_area_get_width(area);
+    uint8_t* dest = headless.framebuffer + area->y1 * headless.stride + area->x1 * 4;
+
+    // Direct and full mode draw straight into the framebuffer, bands are copied in
+    if (pixels != dest) {
+        for (int32_t y = area->y1; y <= area->y2; y++) {
+            memcpy(dest, pixels, w * 4);
+            dest += headless.stride;
+            pixels += stride;
+        }
+    }
+
+    if (headless.flush_cb) {
+        const uint8_t* area_pixels = headless.framebuffer + area->y1 * headless.stride + area->x1 * 4;
+        headless.flush_cb(area, area_pixels, headless.stride, headless.flush_user_data);
+    }
+}
+
+static void pointer_read_cb(lv_indev_t* indev, lv_indev_data_t* data) {
+    if (spark_replay_read_pointer(data)) return;
+
+    if (headless.queue_size > 0) {
+        headless.pointer = headless.queue[headless.queue_head];
+        headless.queue_head = (headless.queue_head + 1) % POINTER_QUEUE_SIZE;
+        headless.queue_size--;
+    }
+
+    data->point.x = headless.pointer.x;
+    data->point.y = headless.pointer.y;
+    data->state = headless.pointer.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    data->continue_reading = headless.queue_size > 0;
+}
+
+static void queue_pointer(PointerState state) {
+    spark_replay_record_pointer(state.x, state.y, state.pressed);
+
+    if (headless.queue_size >= POINTER_QUEUE_SIZE) {
+        // Drop the oldest state rather than the newest
+        headless.queue_head = (headless.queue_head + 1) % POINTER_QUEUE_SIZE;
+        headless.queue_size--;
+    }
+    int tail = (headless.queue_head + headless.queue_size) % POINTER_QUEUE_SIZE;
+    headless.queue[tail] = state;
+    headless.queue_size++;
+}
+
+static PointerState last_pointer(void) {
+    if (headless.queue_size == 0) return headless.pointer;
+    int last = (headless.queue_head + headless.queue_size - 1) % POINTER_QUEUE_SIZE;
+    return headless.queue[last];
+}
+
+bool spark_headless_init(int width, int height) {
+    lv_tick_set_cb(spark_timer_get_ticks);
+
+    lv_display_t* display = lv_display_create(width, height);
+    if (!display) return false;
+
+    headless.width = width;
+    headless.height = height;
+    headless.stride = lv_draw_buf_width_to_stride(width, LV_COLOR_FORMAT_ARGB8888);
+    headless.framebuffer = calloc(headless.stride, height);
+    if (!headless.framebuffer) {
+        lv_display_delete(display);
+        return false;
+    }
+
+    lv_display_set_color_format(display, LV_COLOR_FORMAT_ARGB8888);
+    if (!spark_render_init(display, flush, headless.framebuffer)) {
+        free(headless.framebuffer);
+        headless.framebuffer = NULL;
+        lv_display_delete(display);
+        return false;
+    }
+
+    lv_indev_t* pointer = lv_indev_create();
+    lv_indev_set_type(pointer, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(pointer, pointer_read_cb);
+    lv_indev_set_display(pointer, display);
+
+    spark.display = display;
+    spark.mouse_indev = pointer;
+    return true;
+}
+
+void spark_headless_shutdown(void) {
+    spark_render_shutdown();
+    free(headless.framebuffer);
+    headless.framebuffer = NULL;
+}
+
+void spark_headless_set_flush_callback(SparkHeadlessFlushCallback callback, void* user_data) {
+    headless.flush_cb = callback;
+    headless.flush_user_data = user_data;
+}
+
+const uint8_t* spark_headless_get_framebuffer(int* width, int* height, uint32_t* stride) {
+    if (width) *width = headless.width;
+    if (height) *height = headless.height;
+    if (stride) *stride = headless.stride;
+    return headless.framebuffer;
+}
+
+// Drivers may feed input from their own thread. Ignored while a replay plays.
+void spark_headless_pointer_move(float x, float y) {
+    if (spark_replay_is_playing()) return;
+    spark_lock();
+    PointerState state = last_pointer();
+    state.x = (int32_t)x;
+    state.y = (int32_t)y;
+    queue_pointer(state);
+    spark_unlock();
+}
+
+void spark_headless_pointer_press(void) {
+    if (spark_replay_is_playing()) return;
+    spark_lock();
+    PointerState state = last_pointer();
+    state.pressed = true;
+    queue_pointer(state);
+    spark_unlock();
+}
+
+void spark_headless_pointer_release(void) {
+    if (spark_replay_is_playing()) return;
+    spark_lock();
+    PointerState state = last_pointer();
+    state.pressed = false;
+    queue_pointer(state);
+    spark_unlock();
+}
+
+void spark_headless_pointer_click(float x, float y) {
+    spark_headless_pointer_move(x, y);
+    spark_headless_pointer_press();
+    spark_headless_pointer_release();
+}
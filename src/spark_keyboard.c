@@ -1,12 +1,15 @@
 #include "spark_keyboard.h"
 #include "internal.h"
 #include <SDL2/SDL.h>
+#include <string.h>
 
 static struct {
     bool key_repeat_enabled;
     bool text_input_enabled;
     int key_repeat_delay;
     int key_repeat_interval;
+    bool mapped;
+    bool replay_down[SPARK_SCANCODE_COUNT];  // Key state while a replay plays
 } keyboard_state = {0};
 
 // We only need one table now
@@ -121,6 +124,7 @@ static void init_scancode_mappings(void) {
  for (size_t i = 0; i < sizeof(mappings) / sizeof(mappings[0]); i++) {
         spark_to_sdl_scancode[mappings[i].spark] = mappings[i].sdl;
     }
+    keyboard_state.mapped = true;
 }
 void spark_keyboard_init(void) {
     init_scancode_mappings();
@@ -141,8 +145,31 @@ void spark_keyboard_update(void) {
 }
 
 bool spark_keyboard_is_down(SparkScancode scancode) {
-    const Uint8* keyboard_state = SDL_GetKeyboardState(NULL);  // SDL2 returns Uint8*
-    return keyboard_state[spark_to_sdl_scancode[scancode]] != 0;
+    if (scancode <= SPARK_SCANCODE_UNKNOWN || scancode >= SPARK_SCANCODE_COUNT) return false;
+    if (spark_replay_is_playing()) {
+        return keyboard_state.replay_down[scancode];
+    }
+    if (!keyboard_state.mapped) init_scancode_mappings();
+
+    const Uint8* sdl_state = SDL_GetKeyboardState(NULL);  // SDL2 returns Uint8*
+    return sdl_state[spark_to_sdl_scancode[scancode]] != 0;
+}
+
+int spark_keyboard_from_sdl(SDL_Scancode scancode) {
+    if (!keyboard_state.mapped) init_scancode_mappings();
+    for (int i = SPARK_SCANCODE_UNKNOWN + 1; i < SPARK_SCANCODE_COUNT; i++) {
+        if (spark_to_sdl_scancode[i] == scancode) return i;
+    }
+    return SPARK_SCANCODE_UNKNOWN;
+}
+
+void spark_keyboard_set_replay_key(int scancode, bool down) {
+    if (scancode <= SPARK_SCANCODE_UNKNOWN || scancode >= SPARK_SCANCODE_COUNT) return;
+    keyboard_state.replay_down[scancode] = down;
+}
+
+void spark_keyboard_clear_replay_keys(void) {
+    memset(keyboard_state.replay_down, 0, sizeof(keyboard_state.replay_down));
 }
 
 void spark_keyboard_set_key_repeat(bool enable) {
@@ -0,0 +1,181 @@
+// spark_render.c
+#include "spark_render.h"
+#include "internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "src/display/lv_display_private.h"
+
+static struct {
+    SparkRenderMode mode;
+    int band_lines;
+
+    lv_display_t* display;
+    SparkRenderFlush flush;
+    uint8_t* buffer;          // Owned draw buffer, NULL when the backend lent one
+    uint32_t stride;          // Screen row stride
+    uint32_t pixel_size;
+
+    bool rendering;
+    SparkRenderStats current;
+    SparkRenderStats stats;
+    uint64_t total_merged;
+    uint64_t total_pixels;
+    uint64_t total_flush_bytes;
+} render = {
+    .mode = SPARK_RENDER_DIRECT
+};
+
+void spark_set_render_mode(SparkRenderMode mode, int band_lines) {
+    render.mode = mode;
+    render.band_lines = band_lines > 0 ? band_lines : 0;
+}
+
+SparkRenderMode spark_get_render_mode(void) {
+    return render.mode;
+}
+
+static void flush_cb(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    uint32_t w = lv_area_get_width(area);
+    uint32_t h = lv_area_get_height(area);
+    const uint8_t* pixels;
+    uint32_t stride;
+
+    if (render.mode == SPARK_RENDER_PARTIAL) {
+        // Band buffers only hold the area itself
+        pixels = px_map;
+        stride = lv_draw_buf_width_to_stride(w, lv_display_get_color_format(disp));
+    } else {
+        pixels = px_map + area->y1 * render.stride + area->x1 * render.pixel_size;
+        stride = render.stride;
+    }
+
+    render.current.flushes++;
+    render.current.flush_bytes += (uint64_t)w * h * render.pixel_size;
+
+    if (render.flush) {
+        render.flush(area, pixels, stride, lv_display_flush_is_last(disp));
+    }
+    lv_display_flush_ready(disp);
+}
+
+static void render_event_cb(lv_event_t* e) {
+    lv_display_t* disp = lv_event_get_target(e);
+
+    if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+        // Areas are already joined here, joined ones are skipped by the renderer
+        uint32_t merged = 0;
+        uint64_t pixels = 0;
+        for (uint32_t i = 0; i < disp->inv_p; i++) {
+            if (disp->inv_area_joined[i]) {
+                merged++;
+            } else {
+                pixels += lv_area_get_size(&disp->inv_areas[i]);
+            }
+        }
+        if (render.mode == SPARK_RENDER_FULL) {
+            pixels = (uint64_t)disp->hor_res * disp->ver_res;
+        }
+
+        render.rendering = true;
+        render.current.areas = disp->inv_p;
+        render.current.areas_merged = merged;
+        render.current.rendered_pixels = pixels;
+        render.current.flush_bytes = 0;
+        render.current.flushes = 0;
+        return;
+    }
+
+    // LV_EVENT_REFR_READY
+    if (!render.rendering) return;
+    render.rendering = false;
+
+    render.stats.frames++;
+    render.stats.areas = render.current.areas;
+    render.stats.areas_merged = render.current.areas_merged;
+    render.stats.rendered_pixels = render.current.rendered_pixels;
+    render.stats.flush_bytes = render.current.flush_bytes;
+    render.stats.flushes = render.current.flushes;
+
+    render.total_merged += render.current.areas_merged;
+    render.total_pixels += render.current.rendered_pixels;
+    render.total_flush_bytes += render.current.flush_bytes;
+
+    double frames = (double)render.stats.frames;
+    render.stats.avg_areas_merged = (float)((double)render.total_merged / frames);
+    render.stats.avg_rendered_pixels = (float)((double)render.total_pixels / frames);
+    render.stats.avg_flush_bytes = (float)((double)render.total_flush_bytes / frames);
+}
+
+bool spark_render_init(lv_display_t* display, SparkRenderFlush flush, uint8_t* framebuffer) {
+    lv_color_format_t cf = lv_display_get_color_format(display);
+    int32_t width = lv_display_get_horizontal_resolution(display);
+    int32_t height = lv_display_get_vertical_resolution(display);
+
+    render.display = display;
+    render.flush = flush;
+    render.pixel_size = lv_color_format_get_size(cf);
+    render.stride = lv_draw_buf_width_to_stride(width, cf);
+
+    uint32_t size;
+    lv_display_render_mode_t lv_mode;
+    uint8_t* buffer = NULL;
+
+    switch (render.mode) {
+        case SPARK_RENDER_PARTIAL: {
+            int lines = render.band_lines > 0 ? render.band_lines : (height + 9) / 10;
+            if (lines > height) lines = height;
+            size = render.stride * lines;
+            lv_mode = LV_DISPLAY_RENDER_MODE_PARTIAL;
+            break;
+        }
+        case SPARK_RENDER_FULL:
+            size = render.stride * height;
+            lv_mode = LV_DISPLAY_RENDER_MODE_FULL;
+            buffer = framebuffer;
+            break;
+        case SPARK_RENDER_DIRECT:
+        default:
+            size = render.stride * height;
+            lv_mode = LV_DISPLAY_RENDER_MODE_DIRECT;
+            buffer = framebuffer;
+            break;
+    }
+
+    // Render straight into the backend's framebuffer when it has one
+    if (!buffer) {
+        render.buffer = malloc(size);
+        if (!render.buffer) {
+            fprintf(stderr, "Failed to allocate %u byte draw buffer\n", size);
+            return false;
+        }
+        buffer = render.buffer;
+    }
+
+    lv_display_set_buffers(display, buffer, NULL, size, lv_mode);
+    lv_display_set_flush_cb(display, flush_cb);
+    lv_display_add_event_cb(display, render_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(display, render_event_cb, LV_EVENT_REFR_READY, NULL);
+
+    render.stats.buffer_bytes = size;
+    return true;
+}
+
+void spark_render_shutdown(void) {
+    free(render.buffer);
+    render.buffer = NULL;
+    render.display = NULL;
+}
+
+void spark_render_get_stats(SparkRenderStats* stats) {
+    if (stats) *stats = render.stats;
+}
+
+void spark_render_reset_stats(void) {
+    size_t buffer_bytes = render.stats.buffer_bytes;
+    memset(&render.stats, 0, sizeof(render.stats));
+    render.stats.buffer_bytes = buffer_bytes;
+    render.total_merged = 0;
+    render.total_pixels = 0;
+    render.total_flush_bytes = 0;
+}
@@ -0,0 +1,446 @@
+// spark_replay.c
+#include "spark_replay.h"
+#include "spark_timer.h"
+#include "internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// File layout: "SPKR", version byte, 3 reserved bytes, u32 width, u32 height,
+// then records of a type byte, a varint microsecond delta from the previous
+// record and a type specific payload. Integers are little endian.
+#define REPLAY_MAGIC "SPKR"
+#define REPLAY_VERSION 1
+#define REPLAY_HEADER_SIZE 16
+#define POINTER_QUEUE_SIZE 64
+#define DEFAULT_STEP (1.0 / 60.0)
+
+typedef enum {
+    RECORD_END,
+    RECORD_POINTER,     // zigzag x, zigzag y, u8 pressed
+    RECORD_KEY,         // varint SparkScancode, u8 down
+    RECORD_WHEEL,       // f32 x, f32 y
+    RECORD_RESIZE,      // varint width, varint height
+    RECORD_EVENT        // varint type, varint size, data
+} RecordType;
+
+typedef struct {
+    int32_t x;
+    int32_t y;
+    bool pressed;
+} PointerState;
+
+static struct {
+    FILE* file;
+    bool started;       // Time base is set by the first frame
+    double base;
+    uint64_t last_us;
+} recorder = {0};
+
+static struct {
+    bool playing;
+    bool quit_at_end;
+    bool started;
+    double base;
+    uint8_t* data;
+    size_t size;
+    size_t pos;
+    uint8_t next_type;
+    uint64_t next_us;
+
+    // Every recorded state reaches LVGL as its own read
+    PointerState pointer;
+    PointerState queue[POINTER_QUEUE_SIZE];
+    int queue_head;
+    int queue_size;
+} player = {0};
+
+// Writing
+
+static void write_u8(uint8_t value) {
+    fputc(value, recorder.file);
+}
+
+static void write_u32(uint32_t value) {
+    uint8_t bytes[4] = {
+        (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)
+    };
+    fwrite(bytes, 1, sizeof(bytes), recorder.file);
+}
+
+static void write_varint(uint64_t value) {
+    uint8_t bytes[10];
+    int count = 0;
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        bytes[count++] = value ? byte | 0x80 : byte;
+    } while (value);
+    fwrite(bytes, 1, count, recorder.file);
+}
+
+// Small negative coordinates stay one byte
+static void write_signed(int64_t value) {
+    write_varint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void write_float(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    write_u32(bits);
+}
+
+// Record functions may run on driver threads, spark_lock keeps records whole
+static bool begin_record(RecordType type) {
+    if (!recorder.file) return false;
+
+    uint64_t now = 0;
+    if (recorder.started) {
+        now = (uint64_t)((spark_timer_get_virtual_time() - recorder.base) * 1e6);
+    }
+    if (now < recorder.last_us) now = recorder.last_us;
+
+    write_u8(type);
+    write_varint(now - recorder.last_us);
+    recorder.last_us = now;
+    return true;
+}
+
+void spark_replay_record_pointer(int32_t x, int32_t y, bool pressed) {
+    spark_lock();
+    if (begin_record(RECORD_POINTER)) {
+        write_signed(x);
+        write_signed(y);
+        write_u8(pressed);
+    }
+    spark_unlock();
+}
+
+void spark_replay_record_key(int scancode, bool down) {
+    spark_lock();
+    if (begin_record(RECORD_KEY)) {
+        write_varint((uint64_t)scancode);
+        write_u8(down);
+    }
+    spark_unlock();
+}
+
+void spark_replay_record_wheel(float x, float y) {
+    spark_lock();
+    if (begin_record(RECORD_WHEEL)) {
+        write_float(x);
+        write_float(y);
+    }
+    spark_unlock();
+}
+
+void spark_replay_record_resize(int width, int height) {
+    spark_lock();
+    if (begin_record(RECORD_RESIZE)) {
+        write_varint((uint64_t)width);
+        write_varint((uint64_t)height);
+    }
+    spark_unlock();
+}
+
+void spark_replay_record_event(SparkEventType type, const void* data, size_t size) {
+    spark_lock();
+    if (begin_record(RECORD_EVENT)) {
+        write_varint((uint64_t)type);
+        write_varint(data ? size : 0);
+        if (data && size > 0) fwrite(data, 1, size, recorder.file);
+    }
+    spark_unlock();
+}
+
+bool spark_replay_start_recording(const char* path) {
+    if (!path) return false;
+    if (player.playing) {
+        fprintf(stderr, "Cannot record while a replay is playing\n");
+        return false;
+    }
+    spark_replay_stop_recording();
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Failed to open %s for recording\n", path);
+        return false;
+    }
+
+    spark_lock();
+    recorder.file = file;
+    recorder.started = false;
+    recorder.last_us = 0;
+
+    fwrite(REPLAY_MAGIC, 1, 4, file);
+    write_u8(REPLAY_VERSION);
+    write_u8(0);
+    write_u8(0);
+    write_u8(0);
+    write_u32(spark.display ? (uint32_t)lv_display_get_horizontal_resolution(spark.display) : 0);
+    write_u32(spark.display ? (uint32_t)lv_display_get_vertical_resolution(spark.display) : 0);
+    spark_unlock();
+    return true;
+}
+
+void spark_replay_stop_recording(void) {
+    spark_lock();
+    if (recorder.file) {
+        begin_record(RECORD_END);
+        if (fclose(recorder.file) != 0) {
+            fprintf(stderr, "Failed to write recording\n");
+        }
+        recorder.file = NULL;
+    }
+    spark_unlock();
+}
+
+bool spark_replay_is_recording(void) {
+    return recorder.file != NULL;
+}
+
+// Reading
+
+static bool read_u8(uint8_t* value) {
+    if (player.pos >= player.size) return false;
+    *value = player.data[player.pos++];
+    return true;
+}
+
+static bool read_u32(uint32_t* value) {
+    if (player.size - player.pos < 4) return false;
+    const uint8_t* bytes = player.data + player.pos;
+    *value = (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 |
+             (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+    player.pos += 4;
+    return true;
+}
+
+static bool read_varint(uint64_t* value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && player.pos < player.size; shift += 7) {
+        uint8_t byte = player.data[player.pos++];
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool read_signed(int64_t* value) {
+    uint64_t raw;
+    if (!read_varint(&raw)) return false;
+    *value = (int64_t)(raw >> 1) ^ -(int64_t)(raw & 1);
+    return true;
+}
+
+static bool read_float(float* value) {
+    uint32_t bits;
+    if (!read_u32(&bits)) return false;
+    memcpy(value, &bits, sizeof(bits));
+    return true;
+}
+
+static bool read_header(void) {
+    uint64_t delta;
+    if (!read_u8(&player.next_type) || !read_varint(&delta)) return false;
+    player.next_us += delta;
+    return true;
+}
+
+static void queue_pointer(PointerState state) {
+    if (player.queue_size >= POINTER_QUEUE_SIZE) {
+        player.queue_head = (player.queue_head + 1) % POINTER_QUEUE_SIZE;
+        player.queue_size--;
+    }
+    int tail = (player.queue_head + player.queue_size) % POINTER_QUEUE_SIZE;
+    player.queue[tail] = state;
+    player.queue_size++;
+}
+
+static bool apply_record(void) {
+    switch (player.next_type) {
+        case RECORD_POINTER: {
+            int64_t x, y;
+            uint8_t pressed;
+            if (!read_signed(&x) || !read_signed(&y) || !read_u8(&pressed)) return false;
+            queue_pointer((PointerState){ (int32_t)x, (int32_t)y, pressed != 0 });
+            return true;
+        }
+        case RECORD_KEY: {
+            uint64_t scancode;
+            uint8_t down;
+            if (!read_varint(&scancode) || !read_u8(&down)) return false;
+            spark_keyboard_set_replay_key((int)scancode, down != 0);
+            return true;
+        }
+        case RECORD_WHEEL: {
+            SparkWheelEvent wheel;
+            if (!read_float(&wheel.x) || !read_float(&wheel.y)) return false;
+            spark_event_queue_input(SPARK_EVENT_MOUSEWHEEL, &wheel, sizeof(wheel));
+            return true;
+        }
+        case RECORD_RESIZE: {
+            uint64_t width, height;
+            if (!read_varint(&width) || !read_varint(&height)) return false;
+            SparkResizeEvent resize = { (int)width, (int)height };
+            spark_event_queue_input(SPARK_EVENT_RESIZE, &resize, sizeof(resize));
+            return true;
+        }
+        case RECORD_EVENT: {
+            uint64_t type, size;
+            if (!read_varint(&type) || !read_varint(&size)) return false;
+            if (size > player.size - player.pos) return false;
+            spark_event_queue_input((SparkEventType)type,
+                                    size > 0 ? player.data + player.pos : NULL, (size_t)size);
+            player.pos += (size_t)size;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+static void finish_playback(void) {
+    player.playing = false;
+    spark_keyboard_clear_replay_keys();
+    free(player.data);
+    player.data = NULL;
+}
+
+bool spark_replay_start(const char* path, float step, bool quit_at_end) {
+    if (!path) return false;
+    if (recorder.file) {
+        fprintf(stderr, "Cannot replay while recording\n");
+        return false;
+    }
+    spark_replay_stop();
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Failed to open replay %s\n", path);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t* data = size > 0 ? malloc((size_t)size) : NULL;
+    if (!data || fread(data, 1, (size_t)size, file) != (size_t)size) {
+        fprintf(stderr, "Failed to read replay %s\n", path);
+        free(data);
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+
+    if (size < REPLAY_HEADER_SIZE || memcmp(data, REPLAY_MAGIC, 4) != 0 ||
+        data[4] != REPLAY_VERSION) {
+        fprintf(stderr, "%s is not a Spark2D recording\n", path);
+        free(data);
+        return false;
+    }
+
+    spark_lock();
+    player.data = data;
+    player.size = (size_t)size;
+    player.pos = 8;
+
+    uint32_t width = 0, height = 0;
+    read_u32(&width);
+    read_u32(&height);
+    if (spark.display && (width != (uint32_t)lv_display_get_horizontal_resolution(spark.display) ||
+                          height != (uint32_t)lv_display_get_vertical_resolution(spark.display))) {
+        fprintf(stderr, "Replay %s was recorded at %ux%u\n", path, width, height);
+    }
+
+    player.next_us = 0;
+    player.started = false;
+    player.quit_at_end = quit_at_end;
+    player.queue_head = 0;
+    player.queue_size = 0;
+    player.pointer = (PointerState){0};
+    player.playing = read_header();
+    if (!player.playing) {
+        fprintf(stderr, "Replay %s is empty\n", path);
+        finish_playback();
+    }
+    spark_unlock();
+
+    if (player.playing) {
+        spark_timer_set_virtual_clock(step > 0.0f ? (double)step : DEFAULT_STEP);
+    }
+    return player.playing;
+}
+
+void spark_replay_stop(void) {
+    if (!player.playing) return;
+    spark_lock();
+    finish_playback();
+    spark_unlock();
+    spark_timer_set_virtual_clock(0.0);
+}
+
+bool spark_replay_is_playing(void) {
+    return player.playing;
+}
+
+bool spark_replay_read_pointer(lv_indev_data_t* data) {
+    if (!player.playing && player.queue_size == 0) return false;
+
+    if (player.queue_size > 0) {
+        player.pointer = player.queue[player.queue_head];
+        player.queue_head = (player.queue_head + 1) % POINTER_QUEUE_SIZE;
+        player.queue_size--;
+    }
+
+    data->point.x = player.pointer.x;
+    data->point.y = player.pointer.y;
+    data->state = player.pointer.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    data->continue_reading = player.queue_size > 0;
+    return true;
+}
+
+bool spark_replay_begin_frame(void) {
+    double now = spark_timer_get_virtual_time();
+    if (recorder.file && !recorder.started) {
+        recorder.started = true;
+        recorder.base = now;
+    }
+    if (!player.playing) return false;
+
+    if (!player.started) {
+        player.started = true;
+        player.base = now;
+    }
+    uint64_t now_us = (uint64_t)((now - player.base) * 1e6 + 0.5);
+
+    bool finished = false;
+    spark_lock();
+    while (player.next_us <= now_us) {
+        if (player.next_type == RECORD_END) {
+            finished = true;
+            break;
+        }
+        if (!apply_record() || !read_header()) {
+            fprintf(stderr, "Replay is truncated or corrupt, stopping\n");
+            finished = true;
+            break;
+        }
+    }
+    // The pointer queue still drains through the indev this frame
+    if (finished) finish_playback();
+    spark_unlock();
+
+    if (finished && !player.quit_at_end) {
+        spark_timer_set_virtual_clock(0.0);
+    }
+    return finished && player.quit_at_end;
+}
+
+void spark_replay_shutdown(void) {
+    spark_replay_stop_recording();
+    spark_replay_stop();
+}
@@ -0,0 +1,163 @@
+// spark_sdl.c
+#include "internal.h"
+#include <stdio.h>
+
+#if LV_USE_SDL
+
+// Spark drives the SDL window itself rather than through LVGL's SDL driver,
+// whose buffers and render mode are fixed at compile time
+static struct {
+    SDL_Texture* texture;
+    int32_t pointer_x;
+    int32_t pointer_y;
+    bool pointer_pressed;
+} sdl = {0};
+
+void spark_sdl_present(void) {
+    SDL_RenderClear(spark.renderer);
+    SDL_RenderCopy(spark.renderer, sdl.texture, NULL, NULL);
+    spark_debug_draw_overlay(spark.renderer);
+    SDL_RenderPresent(spark.renderer);
+}
+
+static void flush(const lv_area_t* area, const uint8_t* pixels, uint32_t stride, bool last) {
+    // The streaming texture keeps the previous frame, so only dirty areas are uploaded
+    SDL_Rect rect = {
+        area->x1, area->y1,
+        lv_area_get_width(area), lv_area_get_height(area)
+    };
+    SDL_UpdateTexture(sdl.texture, &rect, pixels, (int)stride);
+
+    if (last) {
+        spark_sdl_present();
+    }
+}
+
+static void pointer_read_cb(lv_indev_t* indev, lv_indev_data_t* data) {
+    if (spark_replay_read_pointer(data)) return;
+
+    data->point.x = sdl.pointer_x;
+    data->point.y = sdl.pointer_y;
+    data->state = sdl.pointer_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+bool spark_sdl_init(const char* title, int width, int height) {
+    // LVGL's SDL driver used to install this
+    lv_tick_set_cb(spark_timer_get_ticks);
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        fprintf(stderr, "SDL initialization failed: %s\n", SDL_GetError());
+        return false;
+    }
+
+    spark.window = SDL_CreateWindow(title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                    width, height, SDL_WINDOW_SHOWN);
+    if (!spark.window) {
+        fprintf(stderr, "SDL window creation failed: %s\n", SDL_GetError());
+        return false;
+    }
+
+    spark.renderer = SDL_CreateRenderer(spark.window, -1, SDL_RENDERER_ACCELERATED);
+    if (!spark.renderer) {
+        spark.renderer = SDL_CreateRenderer(spark.window, -1, 0);
+    }
+    if (!spark.renderer) {
+        fprintf(stderr, "SDL renderer creation failed: %s\n", SDL_GetError());
+        return false;
+    }
+    // Mouse coordinates stay in display pixels if the window is scaled
+    SDL_RenderSetLogicalSize(spark.renderer, width, height);
+
+    sdl.texture = SDL_CreateTexture(spark.renderer, SDL_PIXELFORMAT_ARGB8888,
+                                    SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (!sdl.texture) {
+        fprintf(stderr, "SDL texture creation failed: %s\n", SDL_GetError());
+        return false;
+    }
+
+    lv_display_t* display = lv_display_create(width, height);
+    if (!display) {
+        fprintf(stderr, "LVGL display creation failed\n");
+        return false;
+    }
+    lv_display_set_color_format(display, LV_COLOR_FORMAT_ARGB8888);
+    if (!spark_render_init(display, flush, NULL)) {
+        lv_display_delete(display);
+        return false;
+    }
+
+    lv_indev_t* pointer = lv_indev_create();
+    lv_indev_set_type(pointer, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(pointer, pointer_read_cb);
+    lv_indev_set_display(pointer, display);
+
+    spark.display = display;
+    spark.mouse_indev = pointer;
+    return true;
+}
+
+static bool is_input_event(Uint32 type) {
+    return type == SDL_MOUSEMOTION || type == SDL_MOUSEBUTTONDOWN || type == SDL_MOUSEBUTTONUP ||
+           type == SDL_MOUSEWHEEL || type == SDL_KEYDOWN || type == SDL_KEYUP;
+}
+
+void spark_sdl_handle_event(const SDL_Event* event) {
+    // A replay owns the input until it ends
+    if (spark_replay_is_playing() && is_input_event(event->type)) return;
+
+    switch (event->type) {
+        case SDL_MOUSEMOTION:
+            sdl.pointer_x = event->motion.x;
+            sdl.pointer_y = event->motion.y;
+            spark_replay_record_pointer(sdl.pointer_x, sdl.pointer_y, sdl.pointer_pressed);
+            break;
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            if (event->button.button == SDL_BUTTON_LEFT) {
+                sdl.pointer_x = event->button.x;
+                sdl.pointer_y = event->button.y;
+                sdl.pointer_pressed = event->type == SDL_MOUSEBUTTONDOWN;
+                spark_replay_record_pointer(sdl.pointer_x, sdl.pointer_y, sdl.pointer_pressed);
+            }
+            break;
+        case SDL_MOUSEWHEEL: {
+            SparkWheelEvent wheel = { event->wheel.preciseX, event->wheel.preciseY };
+            spark_event_queue_input(SPARK_EVENT_MOUSEWHEEL, &wheel, sizeof(wheel));
+            spark_replay_record_wheel(wheel.x, wheel.y);
+            break;
+        }
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            if (!event->key.repeat) {
+                spark_replay_record_key(spark_keyboard_from_sdl(event->key.keysym.scancode),
+                                        event->type == SDL_KEYDOWN);
+            }
+            break;
+        case SDL_WINDOWEVENT:
+            if (event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+                SparkResizeEvent resize = { event->window.data1, event->window.data2 };
+                spark_event_queue_input(SPARK_EVENT_RESIZE, &resize, sizeof(resize));
+                spark_replay_record_resize(resize.width, resize.height);
+            }
+            if (event->window.event == SDL_WINDOWEVENT_EXPOSED ||
+                event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+                spark_sdl_present();
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void spark_sdl_shutdown(void) {
+    spark_render_shutdown();
+    if (sdl.texture) SDL_DestroyTexture(sdl.texture);
+    if (spark.renderer) SDL_DestroyRenderer(spark.renderer);
+    if (spark.window) SDL_DestroyWindow(spark.window);
+    sdl.texture = NULL;
+    spark.renderer = NULL;
+    spark.window = NULL;
+    SDL_Quit();
+}
+
+#endif
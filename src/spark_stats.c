@@ -0,0 +1,322 @@
+// spark_stats.c
+#include "spark_stats.h"
+#include "spark_timer.h"
+#include "internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#ifndef __EMSCRIPTEN__
+#include <pthread.h>
+#endif
+
+// One frame of phase timings. seq is odd while the main thread writes the
+// slot, so readers on other threads can detect and skip torn samples.
+typedef struct {
+    unsigned long seq;
+    float ms[SPARK_STATS_PHASE_COUNT];
+} StatsSample;
+
+static const char* phase_names[SPARK_STATS_PHASE_COUNT] = {
+    "events", "update", "layout", "render", "flush", "timers", "sleep", "frame"
+};
+
+static struct {
+    StatsSample ring[SPARK_STATS_RING_SIZE];
+    unsigned long head;      // Samples written so far
+    unsigned long reset_at;  // head at the last spark_stats_reset
+
+    // Current frame, main thread only
+    float current[SPARK_STATS_PHASE_COUNT];
+    double frame_start;
+    double refr_start;
+    double render_start;
+    double flush_start;
+    float render_flush;      // Flush time spent inside the current render
+} stats = {0};
+
+void spark_stats_begin_frame(void) {
+    memset(stats.current, 0, sizeof(stats.current));
+    stats.frame_start = spark_timer_get_time();
+}
+
+void spark_stats_add(SparkStatsPhase phase, double seconds) {
+    stats.current[phase] += (float)(seconds * 1000.0);
+}
+
+void spark_stats_add_timer_handler(double seconds) {
+    // Whatever lv_timer_handler spent outside the display refresh
+    float ms = (float)(seconds * 1000.0)
+        - stats.current[SPARK_STATS_PHASE_LAYOUT]
+        - stats.current[SPARK_STATS_PHASE_RENDER]
+        - stats.current[SPARK_STATS_PHASE_FLUSH];
+    stats.current[SPARK_STATS_PHASE_TIMERS] += ms > 0.0f ? ms : 0.0f;
+}
+
+void spark_stats_end_frame(void) {
+    stats.current[SPARK_STATS_PHASE_FRAME] =
+        (float)((spark_timer_get_time() - stats.frame_start) * 1000.0);
+
+    unsigned long head = stats.head;
+    StatsSample* sample = &stats.ring[head % SPARK_STATS_RING_SIZE];
+    unsigned long seq = sample->seq;
+
+    __atomic_store_n(&sample->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(sample->ms, stats.current, sizeof(sample->ms));
+    __atomic_store_n(&sample->seq, seq + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&stats.head, head + 1, __ATOMIC_RELEASE);
+}
+
+static void display_event_cb(lv_event_t* e) {
+    double now = spark_timer_get_time();
+
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_REFR_START:
+            stats.refr_start = now;
+            stats.render_start = now;
+            break;
+        case LV_EVENT_RENDER_START:
+            spark_stats_add(SPARK_STATS_PHASE_LAYOUT, now - stats.refr_start);
+            stats.render_start = now;
+            stats.render_flush = 0.0f;
+            break;
+        case LV_EVENT_RENDER_READY:
+            spark_stats_add(SPARK_STATS_PHASE_RENDER, now - stats.render_start);
+            stats.current[SPARK_STATS_PHASE_RENDER] -= stats.render_flush;
+            break;
+        case LV_EVENT_FLUSH_START:
+            stats.flush_start = now;
+            break;
+        case LV_EVENT_FLUSH_FINISH: {
+            float ms = (float)((now - stats.flush_start) * 1000.0);
+            stats.current[SPARK_STATS_PHASE_FLUSH] += ms;
+            stats.render_flush += ms;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void spark_stats_attach_display(lv_display_t* display) {
+    lv_display_add_event_cb(display, display_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(display, display_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(display, display_event_cb, LV_EVENT_RENDER_READY, NULL);
+    lv_display_add_event_cb(display, display_event_cb, LV_EVENT_FLUSH_START, NULL);
+    lv_display_add_event_cb(display, display_event_cb, LV_EVENT_FLUSH_FINISH, NULL);
+}
+
+static int compare_floats(const void* a, const void* b) {
+    float fa = *(const float*)a;
+    float fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+static float percentile(const float* sorted, int count, float p) {
+    int index = (int)ceilf(p * count) - 1;
+    if (index < 0) index = 0;
+    if (index >= count) index = count - 1;
+    return sorted[index];
+}
+
+// Copies consistent samples out of the ring, returns how many
+static int snapshot(float (*out)[SPARK_STATS_PHASE_COUNT], unsigned long* frames) {
+    unsigned long head = __atomic_load_n(&stats.head, __ATOMIC_ACQUIRE);
+    unsigned long reset_at = __atomic_load_n(&stats.reset_at, __ATOMIC_ACQUIRE);
+    unsigned long available = head - reset_at;
+    unsigned long count = available < SPARK_STATS_RING_SIZE ? available : SPARK_STATS_RING_SIZE;
+    int n = 0;
+
+    for (unsigned long i = head - count; i < head; i++) {
+        StatsSample* sample = &stats.ring[i % SPARK_STATS_RING_SIZE];
+        unsigned long before = __atomic_load_n(&sample->seq, __ATOMIC_ACQUIRE);
+        if (before & 1) continue;
+
+        memcpy(out[n], sample->ms, sizeof(sample->ms));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&sample->seq, __ATOMIC_RELAXED) != before) continue;
+        n++;
+    }
+
+    *frames = available;
+    return n;
+}
+
+bool spark_stats_get(SparkStats* out) {
+    if (!out) return false;
+    memset(out, 0, sizeof(*out));
+
+    float (*samples)[SPARK_STATS_PHASE_COUNT] = malloc(sizeof(*samples) * SPARK_STATS_RING_SIZE);
+    float* values = malloc(sizeof(float) * SPARK_STATS_RING_SIZE);
+    if (!samples || !values) {
+        free(samples);
+        free(values);
+        return false;
+    }
+
+    int count = snapshot(samples, &out->frames);
+    out->samples = count;
+
+    spark_text_measure_get_counts(&out->text_measure_hits, &out->text_measure_misses);
+    unsigned long lookups = out->text_measure_hits + out->text_measure_misses;
+    if (lookups > 0) out->text_measure_hit_rate = (float)out->text_measure_hits / (float)lookups;
+
+    for (int phase = 0; phase < SPARK_STATS_PHASE_COUNT && count > 0; phase++) {
+        double sum = 0.0;
+        for (int i = 0; i < count; i++) {
+            values[i] = samples[i][phase];
+            sum += (double)values[i];
+        }
+        qsort(values, count, sizeof(float), compare_floats);
+
+        SparkStatsPhaseSummary* summary = &out->phases[phase];
+        summary->p50 = percentile(values, count, 0.50f);
+        summary->p95 = percentile(values, count, 0.95f);
+        summary->p99 = percentile(values, count, 0.99f);
+        summary->max = values[count - 1];
+        summary->mean = (float)(sum / count);
+    }
+
+    free(samples);
+    free(values);
+    return count > 0;
+}
+
+const char* spark_stats_phase_name(SparkStatsPhase phase) {
+    if (phase < 0 || phase >= SPARK_STATS_PHASE_COUNT) return "unknown";
+    return phase_names[phase];
+}
+
+void spark_stats_reset(void) {
+    __atomic_store_n(&stats.reset_at, __atomic_load_n(&stats.head, __ATOMIC_ACQUIRE),
+                     __ATOMIC_RELEASE);
+    spark_text_measure_reset_counts();
+}
+
+// Exporter
+
+#ifndef __EMSCRIPTEN__
+static struct {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool running;
+    FILE* file;
+    SparkStatsFormat format;
+    double interval;
+} exporter = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER
+};
+
+static void write_csv_header(FILE* file) {
+    fprintf(file, "time,frames,samples");
+    for (int phase = 0; phase < SPARK_STATS_PHASE_COUNT; phase++) {
+        const char* name = phase_names[phase];
+        fprintf(file, ",%s_p50,%s_p95,%s_p99,%s_max,%s_mean", name, name, name, name, name);
+    }
+    fprintf(file, ",text_measure_hit_rate\n");
+}
+
+static void write_summary(FILE* file, SparkStatsFormat format, const SparkStats* s) {
+    double now = spark_timer_get_time();
+
+    if (format == SPARK_STATS_FORMAT_CSV) {
+        fprintf(file, "%.3f,%lu,%d", now, s->frames, s->samples);
+        for (int phase = 0; phase < SPARK_STATS_PHASE_COUNT; phase++) {
+            const SparkStatsPhaseSummary* p = &s->phases[phase];
+            fprintf(file, ",%.3f,%.3f,%.3f,%.3f,%.3f",
+                    (double)p->p50, (double)p->p95, (double)p->p99, (double)p->max, (double)p->mean);
+        }
+        fprintf(file, ",%.3f\n", (double)s->text_measure_hit_rate);
+    } else {
+        fprintf(file, "{\"time\":%.3f,\"frames\":%lu,\"samples\":%d,\"phases\":{",
+                now, s->frames, s->samples);
+        for (int phase = 0; phase < SPARK_STATS_PHASE_COUNT; phase++) {
+            const SparkStatsPhaseSummary* p = &s->phases[phase];
+            fprintf(file, "%s\"%s\":{\"p50\":%.3f,\"p95\":%.3f,\"p99\":%.3f,\"max\":%.3f,\"mean\":%.3f}",
+                    phase > 0 ? "," : "", phase_names[phase],
+                    (double)p->p50, (double)p->p95, (double)p->p99, (double)p->max, (double)p->mean);
+        }
+        fprintf(file, "},\"text_measure_hit_rate\":%.3f}\n", (double)s->text_measure_hit_rate);
+    }
+    fflush(file);
+}
+
+static void* exporter_main(void* arg) {
+    pthread_mutex_lock(&exporter.mutex);
+    while (exporter.running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        double whole;
+        double frac = modf(exporter.interval, &whole);
+        deadline.tv_sec += (time_t)whole;
+        deadline.tv_nsec += (long)(frac * 1e9);
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        pthread_cond_timedwait(&exporter.cond, &exporter.mutex, &deadline);
+        if (!exporter.running) break;
+
+        SparkStats summary;
+        if (spark_stats_get(&summary)) {
+            write_summary(exporter.file, exporter.format, &summary);
+        }
+    }
+    pthread_mutex_unlock(&exporter.mutex);
+    return NULL;
+}
+#endif
+
+bool spark_stats_start_exporter(const char* path, SparkStatsFormat format, float interval) {
+#ifndef __EMSCRIPTEN__
+    if (!path || interval <= 0.0f || exporter.running) return false;
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Failed to open stats export file: %s\n", path);
+        return false;
+    }
+    if (format == SPARK_STATS_FORMAT_CSV) {
+        write_csv_header(file);
+    }
+
+    exporter.file = file;
+    exporter.format = format;
+    exporter.interval = interval;
+    exporter.running = true;
+
+    if (pthread_create(&exporter.thread, NULL, exporter_main, NULL) != 0) {
+        fprintf(stderr, "Failed to start stats exporter thread\n");
+        exporter.running = false;
+        fclose(file);
+        exporter.file = NULL;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void spark_stats_stop_exporter(void) {
+#ifndef __EMSCRIPTEN__
+    pthread_mutex_lock(&exporter.mutex);
+    if (!exporter.running) {
+        pthread_mutex_unlock(&exporter.mutex);
+        return;
+    }
+    exporter.running = false;
+    pthread_cond_signal(&exporter.cond);
+    pthread_mutex_unlock(&exporter.mutex);
+
+    pthread_join(exporter.thread, NULL);
+    fclose(exporter.file);
+    exporter.file = NULL;
+#endif
+}
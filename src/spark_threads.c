@@ -0,0 +1,108 @@
+// spark_threads.c
+#include "spark2d.h"
+#include "internal.h"
+#include <stdio.h>
+#include <string.h>
+#include "src/core/lv_global.h"
+#include "src/draw/lv_draw_private.h"
+
+// LVGL starts every software draw unit (and its thread) in lv_init. Units
+// past the requested count are unlinked from the dispatch list so their
+// threads stay parked, and are linked back before lv_deinit frees them.
+static struct {
+    lv_draw_unit_t* sw_units[SPARK_DRAW_UNIT_MAX];
+    int sw_unit_count;
+    lv_draw_unit_t* other_units;  // Non-SW units, kept in their original order
+    int requested;                // 0 uses every compiled-in unit
+    int active;
+} threads = {0};
+
+static bool is_sw_unit(lv_draw_unit_t* unit) {
+    return unit->name && strstr(unit->name, "SW") != NULL;
+}
+
+static void relink_units(int count) {
+    lv_draw_global_info_t* info = &LV_GLOBAL_DEFAULT()->draw_info;
+    lv_draw_unit_t* head = threads.other_units;
+    uint32_t total = 0;
+
+    for (lv_draw_unit_t* u = head; u; u = u->next) total++;
+
+    // Dispatch walks the list from the head, so SW units go in front
+    for (int i = count - 1; i >= 0; i--) {
+        threads.sw_units[i]->next = head;
+        head = threads.sw_units[i];
+        total++;
+    }
+
+    info->unit_head = head;
+    info->unit_cnt = total;
+    threads.active = count;
+}
+
+void spark_threads_init(void) {
+    lv_draw_global_info_t* info = &LV_GLOBAL_DEFAULT()->draw_info;
+    lv_draw_unit_t* others_tail = NULL;
+
+    threads.sw_unit_count = 0;
+    threads.other_units = NULL;
+
+    lv_draw_unit_t* unit = info->unit_head;
+    while (unit) {
+        lv_draw_unit_t* next = unit->next;
+        unit->next = NULL;
+
+        if (is_sw_unit(unit) && threads.sw_unit_count < SPARK_DRAW_UNIT_MAX) {
+            threads.sw_units[threads.sw_unit_count++] = unit;
+        } else if (others_tail) {
+            others_tail->next = unit;
+            others_tail = unit;
+        } else {
+            threads.other_units = others_tail = unit;
+        }
+        unit = next;
+    }
+
+    int count = threads.requested;
+    if (count <= 0 || count > threads.sw_unit_count) {
+        count = threads.sw_unit_count;
+    }
+    relink_units(count);
+}
+
+void spark_threads_deinit(void) {
+    // lv_deinit deletes units through the list, parked ones included
+    if (threads.sw_unit_count > 0) {
+        relink_units(threads.sw_unit_count);
+    }
+}
+
+void spark_set_draw_units(int count) {
+    threads.requested = count;
+    if (threads.sw_unit_count == 0) return;  // Applied in spark_init
+
+    if (count <= 0 || count > threads.sw_unit_count) {
+        count = threads.sw_unit_count;
+    }
+
+    // Holding the lock keeps this between frames, when no unit is busy
+    lv_lock();
+    relink_units(count);
+    lv_unlock();
+}
+
+int spark_get_draw_units(void) {
+    return threads.active;
+}
+
+int spark_get_max_draw_units(void) {
+    return SPARK_DRAW_UNIT_MAX;
+}
+
+void spark_lock(void) {
+    lv_lock();
+}
+
+void spark_unlock(void) {
+    lv_unlock();
+}
@@ -0,0 +1,204 @@
+// spark_timer.c
+#include "spark_timer.h"
+#include "internal.h"
+#include <stdint.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+#define NSEC_PER_SEC 1000000000ULL
+#define MAX_DELTA 0.25  // Longest dt handed to update in variable-step mode
+
+static struct {
+    uint64_t epoch;         // Monotonic ns at spark_timer_init
+    uint64_t frame_start;   // Monotonic ns at the start of the current frame
+    uint64_t deadline;      // Monotonic ns the current frame should end at
+    double delta;           // Measured dt of the current frame
+    double period;          // 1 / target fps, 0 when uncapped
+    double fixed_step;
+    double accumulator;
+    int max_steps;
+    unsigned long skipped_steps;
+    double window[SPARK_TIMER_WINDOW];
+    int window_pos;
+    int window_count;
+    double virtual_step;    // Fixed dt per frame for replays, 0 uses the real clock
+    double virtual_time;
+    double clock_offset;    // How far replays left the tick clock ahead of the wall clock
+} pacer = {
+    .period = 1.0 / 60.0,
+    .max_steps = 5
+};
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NSEC_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t target) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(target / NSEC_PER_SEC),
+        .tv_nsec = (long)(target % NSEC_PER_SEC)
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+void spark_timer_init(void) {
+    pacer.epoch = monotonic_ns();
+    spark_timer_reset();
+}
+
+void spark_timer_reset(void) {
+    pacer.frame_start = monotonic_ns();
+    pacer.deadline = pacer.frame_start;
+    pacer.delta = 0.0;
+    pacer.accumulator = 0.0;
+    pacer.window_pos = 0;
+    pacer.window_count = 0;
+}
+
+int spark_timer_begin_frame(float* step) {
+    uint64_t now = monotonic_ns();
+    pacer.delta = (double)(now - pacer.frame_start) / NSEC_PER_SEC;
+    pacer.frame_start = now;
+
+    if (pacer.virtual_step > 0.0) {
+        pacer.delta = pacer.virtual_step;
+        pacer.virtual_time += pacer.virtual_step;
+    }
+
+    pacer.window[pacer.window_pos] = pacer.delta;
+    pacer.window_pos = (pacer.window_pos + 1) % SPARK_TIMER_WINDOW;
+    if (pacer.window_count < SPARK_TIMER_WINDOW) {
+        pacer.window_count++;
+    }
+
+    if (pacer.fixed_step <= 0.0) {
+        *step = (float)fmin(pacer.delta, MAX_DELTA);
+        return 1;
+    }
+
+    pacer.accumulator += pacer.delta;
+    int steps = (int)(pacer.accumulator / pacer.fixed_step);
+    if (steps > pacer.max_steps) {
+        // Drop the backlog rather than spiral trying to catch up
+        pacer.skipped_steps += (unsigned long)(steps - pacer.max_steps);
+        pacer.accumulator = fmod(pacer.accumulator, pacer.fixed_step);
+        steps = pacer.max_steps;
+    } else {
+        pacer.accumulator -= steps * pacer.fixed_step;
+    }
+
+    *step = (float)pacer.fixed_step;
+    return steps;
+}
+
+void spark_timer_end_frame(void) {
+    // Virtual time runs as fast as frames can be produced
+    if (pacer.period <= 0.0 || pacer.virtual_step > 0.0) return;
+
+    uint64_t period = (uint64_t)(pacer.period * NSEC_PER_SEC);
+    uint64_t now = monotonic_ns();
+
+    pacer.deadline += period;
+    if (pacer.deadline + period < now) {
+        // More than a frame late: resync instead of bursting frames back to back
+        pacer.deadline = now;
+        return;
+    }
+    if (pacer.deadline > now) {
+        sleep_until(pacer.deadline);
+    }
+}
+
+double spark_timer_get_time(void) {
+    return (double)(monotonic_ns() - pacer.epoch) / NSEC_PER_SEC;
+}
+
+void spark_timer_set_virtual_clock(double step) {
+    // Both directions continue from the clock's current reading. A replay
+    // can run ahead of the wall clock, so leaving one keeps that lead as an
+    // offset instead of jumping back and wrapping LVGL's elapsed ticks.
+    double clock = spark_timer_get_virtual_time();
+    pacer.virtual_step = step > 0.0 ? step : 0.0;
+    pacer.virtual_time = clock;
+    pacer.clock_offset = fmax(pacer.clock_offset, clock - spark_timer_get_time());
+}
+
+double spark_timer_get_virtual_time(void) {
+    if (pacer.virtual_step > 0.0) return pacer.virtual_time;
+    return spark_timer_get_time() + pacer.clock_offset;
+}
+
+uint32_t spark_timer_get_ticks(void) {
+    return (uint32_t)(spark_timer_get_virtual_time() * 1000.0);
+}
+
+float spark_timer_get_delta(void) {
+    return (float)pacer.delta;
+}
+
+void spark_timer_sleep(double seconds) {
+    if (seconds <= 0.0) return;
+    sleep_until(monotonic_ns() + (uint64_t)(seconds * NSEC_PER_SEC));
+}
+
+void spark_timer_set_target_fps(float fps) {
+    pacer.period = fps > 0.0f ? 1.0 / (double)fps : 0.0;
+    pacer.deadline = monotonic_ns();
+}
+
+float spark_timer_get_target_fps(void) {
+    return pacer.period > 0.0 ? (float)(1.0 / pacer.period) : 0.0f;
+}
+
+void spark_timer_set_fixed_step(float step) {
+    pacer.fixed_step = step > 0.0f ? (double)step : 0.0;
+    pacer.accumulator = 0.0;
+}
+
+float spark_timer_get_fixed_step(void) {
+    return (float)pacer.fixed_step;
+}
+
+void spark_timer_set_max_steps(int max_steps) {
+    pacer.max_steps = max_steps > 0 ? max_steps : 1;
+}
+
+float spark_timer_get_alpha(void) {
+    if (pacer.fixed_step <= 0.0) return 1.0f;
+    return (float)(pacer.accumulator / pacer.fixed_step);
+}
+
+float spark_timer_get_average_delta(void) {
+    if (pacer.window_count == 0) return 0.0f;
+
+    double sum = 0.0;
+    for (int i = 0; i < pacer.window_count; i++) {
+        sum += pacer.window[i];
+    }
+    return (float)(sum / pacer.window_count);
+}
+
+float spark_timer_get_fps(void) {
+    float average = spark_timer_get_average_delta();
+    return average > 0.0f ? 1.0f / average : 0.0f;
+}
+
+float spark_timer_get_delta_variance(void) {
+    if (pacer.window_count < 2) return 0.0f;
+
+    double mean = spark_timer_get_average_delta();
+    double sum = 0.0;
+    for (int i = 0; i < pacer.window_count; i++) {
+        double d = pacer.window[i] - mean;
+        sum += d * d;
+    }
+    return (float)(sum / (pacer.window_count - 1));
+}
+
+unsigned long spark_timer_get_skipped_steps(void) {
+    return pacer.skipped_steps;
+}
@@ -31,4 +31,10 @@ void spark_window_update_scale(void) {
     spark.window_state.viewport = (SDL_Rect){
         0, 0, current_w, current_h
     };
+}
+
+void spark_window_set_title(const char* title) {
+    if (spark.window) {
+        SDL_SetWindowTitle(spark.window, title);
+    }
 }
\ No newline at end of file
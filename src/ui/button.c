@@ -92,9 +92,22 @@ SparkButton* spark_ui_button_new_text(float x, float y, float width, float heigh
         return NULL;
     }
 
-    lv_label_set_text(button->label, text);
+    spark_label_text_set(button->label, &button->text, __func__, text);
     lv_obj_center(button->label);
 
+    // Width or height 0 fits the text
+    if (width <= 0.0f || height <= 0.0f) {
+        float text_width, text_height;
+        spark_ui_button_get_text_size(button, &text_width, &text_height);
+        int32_t pad_x = lv_obj_get_style_pad_left(button->button, LV_PART_MAIN) +
+                        lv_obj_get_style_pad_right(button->button, LV_PART_MAIN);
+        int32_t pad_y = lv_obj_get_style_pad_top(button->button, LV_PART_MAIN) +
+                        lv_obj_get_style_pad_bottom(button->button, LV_PART_MAIN);
+        if (width <= 0.0f) width = text_width + (float)pad_x;
+        if (height <= 0.0f) height = text_height + (float)pad_y;
+        spark_ui_button_set_size(button, width, height);
+    }
+
     return button;
 }
 
@@ -135,7 +148,7 @@ SparkButton* spark_ui_button_new_text_and_image(float x, float y, float width, f
     }
 
     lv_img_set_src(button->image, img_src);
-    lv_label_set_text(button->label, text);
+    spark_label_text_set(button->label, &button->text, __func__, text);
 
     // Arrange image and text vertically
     lv_obj_align(button->image, LV_ALIGN_TOP_MID, 0, 5);
@@ -152,6 +165,7 @@ void spark_ui_button_set_callback(SparkButton* button, SparkButtonCallback callb
 
 void spark_ui_button_set_position(SparkButton* button, float x, float y) {
     if (!button || !button->button) return;
+    SPARK_TRACE_INVALIDATION(button->button);
     button->x = x;
     button->y = y;
     lv_obj_set_pos(button->button, (lv_coord_t)x, (lv_coord_t)y);
@@ -159,6 +173,7 @@ void spark_ui_button_set_position(SparkButton* button, float x, float y) {
 
 void spark_ui_button_set_size(SparkButton* button, float width, float height) {
     if (!button || !button->button) return;
+    SPARK_TRACE_INVALIDATION(button->button);
     button->width = width;
     button->height = height;
     lv_obj_set_size(button->button, (lv_coord_t)width, (lv_coord_t)height);
@@ -181,9 +196,31 @@ const char* spark_ui_button_get_text(const SparkButton* button) {
     return lv_label_get_text(button->label);
 }
 
+// The label's text in its font, through the measurement cache
+void spark_ui_button_get_text_size(const SparkButton* button, float* width, float* height) {
+    int32_t w = 0, h = 0;
+    if (button && button->label) {
+        spark_graphics_measure_text(lv_label_get_text(button->label),
+                                    lv_obj_get_style_text_font(button->label, LV_PART_MAIN),
+                                    lv_obj_get_style_text_letter_space(button->label, LV_PART_MAIN),
+                                    lv_obj_get_style_text_line_space(button->label, LV_PART_MAIN),
+                                    0, &w, &h);
+    }
+    if (width) *width = (float)w;
+    if (height) *height = (float)h;
+}
+
 void spark_ui_button_set_text(SparkButton* button, const char* text) {
     if (!button || !button->label) return;
-    lv_label_set_text(button->label, text);
+    spark_label_text_set(button->label, &button->text, __func__, text);
+}
+
+void spark_ui_button_set_textf(SparkButton* button, const char* format, ...) {
+    if (!button || !button->label || !format) return;
+    va_list args;
+    va_start(args, format);
+    spark_label_text_vset(button->label, &button->text, __func__, format, args);
+    va_end(args);
 }
 
 void spark_ui_button_free(SparkButton* button) {
@@ -197,6 +234,6 @@ void spark_ui_button_free(SparkButton* button) {
         }
         lv_obj_del(button->button);  // This will also delete child objects (label/image)
     }
-    
+    spark_label_text_free(&button->text);
     free(button);
 }
\ No newline at end of file
@@ -65,6 +65,7 @@ void spark_ui_container_free(SparkContainer* container) {
 
 void spark_ui_container_set_parent(SparkContainer* container, SparkContainer* parent) {
     if (!container || !container->container) return;
+    SPARK_TRACE_INVALIDATION(container->container);
     if (!parent) {
         lv_obj_set_parent(container->container, lv_screen_active());
     } else {
@@ -86,6 +87,7 @@ void* spark_ui_container_get_native_handle(const SparkContainer* container) {
 
 void spark_ui_container_set_position(SparkContainer* container, float x, float y) {
     if (!container || !container->container) return;
+    SPARK_TRACE_INVALIDATION(container->container);
     container->x = x;
     container->y = y;
     lv_obj_set_pos(container->container, (lv_coord_t)x, (lv_coord_t)y);
@@ -93,6 +95,7 @@ void spark_ui_container_set_position(SparkContainer* container, float x, float y
 
 void spark_ui_container_set_size(SparkContainer* container, float width, float height) {
     if (!container || !container->container) return;
+    SPARK_TRACE_INVALIDATION(container->container);
     container->width = width;
     container->height = height;
     lv_obj_set_size(container->container, (lv_coord_t)width, (lv_coord_t)height);
@@ -117,6 +120,7 @@ void spark_ui_container_clear(SparkContainer* container) {
 
 void spark_ui_container_set_visible(SparkContainer* container, bool visible) {
     if (!container || !container->container) return;
+    SPARK_TRACE_INVALIDATION(container->container);
     container->is_visible = visible;
     if (visible) {
         lv_obj_clear_flag(container->container, LV_OBJ_FLAG_HIDDEN);
@@ -132,6 +136,7 @@ bool spark_ui_container_is_visible(const SparkContainer* container) {
 
 void spark_ui_container_set_transparent(SparkContainer* container, bool transparent) {
     if (!container || !container->container) return;
+    SPARK_TRACE_INVALIDATION(container->container);
     lv_obj_set_style_bg_opa(container->container, 
                            transparent ? LV_OPA_TRANSP : LV_OPA_COVER, 
                            0);
@@ -139,6 +144,7 @@ void spark_ui_container_set_transparent(SparkContainer* container, bool transpar
 
 void spark_ui_container_set_background_color(SparkContainer* container, float r, float g, float b) {
     if (!container || !container->container) return;
+    SPARK_TRACE_INVALIDATION(container->container);
     lv_color_t color = lv_color_make((uint8_t)(r * 255), 
                                     (uint8_t)(g * 255), 
                                     (uint8_t)(b * 255));
@@ -147,6 +153,7 @@ void spark_ui_container_set_background_color(SparkContainer* container, float r,
 
 void spark_ui_container_set_background_opacity(SparkContainer* container, float opacity) {
     if (!container || !container->container) return;
+    SPARK_TRACE_INVALIDATION(container->container);
     lv_obj_set_style_bg_opa(container->container, (lv_opa_t)(opacity * 255), 0);
 }
 
@@ -91,6 +91,7 @@ void spark_ui_dropdown_clear_items(SparkDropdown* dropdown) {
 
 void spark_ui_dropdown_set_selected(SparkDropdown* dropdown, int index) {
     if (!dropdown) return;
+    SPARK_TRACE_INVALIDATION(dropdown->dropdown);
     lv_dropdown_set_selected(dropdown->dropdown, index);
 }
 
@@ -114,6 +115,7 @@ void spark_ui_dropdown_set_callback(SparkDropdown* dropdown, SparkDropdownCallba
 
 void spark_ui_dropdown_set_position(SparkDropdown* dropdown, float x, float y) {
     if (!dropdown) return;
+    SPARK_TRACE_INVALIDATION(dropdown->dropdown);
     dropdown->x = x;
     dropdown->y = y;
     lv_obj_set_pos(dropdown->dropdown, (lv_coord_t)x, (lv_coord_t)y);
@@ -121,6 +123,7 @@ void spark_ui_dropdown_set_position(SparkDropdown* dropdown, float x, float y) {
 
 void spark_ui_dropdown_set_size(SparkDropdown* dropdown, float width, float height) {
     if (!dropdown) return;
+    SPARK_TRACE_INVALIDATION(dropdown->dropdown);
     dropdown->width = width;
     dropdown->height = height;
     lv_obj_set_size(dropdown->dropdown, (lv_coord_t)width, (lv_coord_t)height);
@@ -3,6 +3,127 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+
+// Label text updates
+
+// Only next grows, shown is LVGL's text until the swap
+static bool reserve_text(SparkLabelText* text, size_t size) {
+    if (size <= text->next_capacity) return true;
+    size_t capacity = text->next_capacity > 0 ? text->next_capacity : 32;
+    while (capacity < size) capacity *= 2;
+
+    char* next = realloc(text->next, capacity);
+    if (!next) return false;
+    text->next = next;
+    text->next_capacity = capacity;
+    return true;
+}
+
+// Where the label's text is drawn, or all of it when that can't be told
+// from a measurement: scrolling and dotted labels, or unusual alignments
+static void get_text_area(lv_obj_t* label, const char* string, lv_area_t* area) {
+    lv_obj_get_coords(label, area);
+    if (lv_label_get_long_mode(label) != LV_LABEL_LONG_WRAP && lv_label_get_long_mode(label) != LV_LABEL_LONG_CLIP) {
+        return;
+    }
+
+    lv_area_t content;
+    lv_obj_get_content_coords(label, &content);
+    bool fixed_width = lv_obj_get_style_width(label, LV_PART_MAIN) != LV_SIZE_CONTENT;
+    int32_t width, height;
+    spark_graphics_measure_text(string, lv_obj_get_style_text_font(label, LV_PART_MAIN),
+                                lv_obj_get_style_text_letter_space(label, LV_PART_MAIN),
+                                lv_obj_get_style_text_line_space(label, LV_PART_MAIN),
+                                fixed_width ? lv_area_get_width(&content) : 0, &width, &height);
+
+    lv_area_t text = content;
+    switch (lv_obj_get_style_text_align(label, LV_PART_MAIN)) {
+        case LV_TEXT_ALIGN_LEFT:
+            text.x2 = text.x1 + width - 1;
+            break;
+        case LV_TEXT_ALIGN_RIGHT:
+            text.x1 = text.x2 - width + 1;
+            break;
+        case LV_TEXT_ALIGN_CENTER:
+            text.x1 += (lv_area_get_width(&content) - width) / 2;
+            text.x2 = text.x1 + width - 1;
+            break;
+        default:
+            break;
+    }
+    text.y2 = text.y1 + height - 1;
+    if (!lv_area_intersect(area, area, &text)) area->x2 = area->x1 - 1;
+}
+
+// LVGL copies the string and invalidates the whole label; here the new
+// text is only swapped in, and just the old and new text is redrawn. A
+// content-sized label that changes size is also invalidated by the layout.
+static bool apply_text(lv_obj_t* label, SparkLabelText* text, const char* function) {
+    if (text->shown && strcmp(text->shown, text->next) == 0) return false;
+
+    SparkTraceScope scope = spark_debug_trace_begin(function, label);
+    lv_area_t old_area;
+    get_text_area(label, text->shown ? text->shown : lv_label_get_text(label), &old_area);
+
+    char* shown = text->next;
+    size_t shown_capacity = text->next_capacity;
+    text->next = text->shown;
+    text->next_capacity = text->shown_capacity;
+    text->shown = shown;
+    text->shown_capacity = shown_capacity;
+
+    lv_display_t* display = lv_obj_get_display(label);
+    bool enabled = lv_display_is_invalidation_enabled(display);
+    lv_display_enable_invalidation(display, false);
+    lv_label_set_text_static(label, text->shown);
+    lv_display_enable_invalidation(display, enabled);
+
+    lv_area_t area;
+    get_text_area(label, text->shown, &area);
+    bool has_old = lv_area_get_width(&old_area) > 0;
+    bool has_new = lv_area_get_width(&area) > 0;
+    if (has_old && has_new && lv_area_is_on(&area, &old_area)) {
+        lv_area_join(&area, &area, &old_area);
+        lv_obj_invalidate_area(label, &area);
+    } else {
+        if (has_old) lv_obj_invalidate_area(label, &old_area);
+        if (has_new) lv_obj_invalidate_area(label, &area);
+    }
+    spark_debug_trace_end(&scope);
+    return true;
+}
+
+bool spark_label_text_vset(lv_obj_t* label, SparkLabelText* text, const char* function,
+                           const char* format, va_list args) {
+    if (!reserve_text(text, 32)) return false;
+
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(text->next, text->next_capacity, format, copy);
+    va_end(copy);
+    if (length < 0) return false;
+    if ((size_t)length >= text->next_capacity) {
+        if (!reserve_text(text, (size_t)length + 1)) return false;
+        vsnprintf(text->next, text->next_capacity, format, args);
+    }
+    return apply_text(label, text, function);
+}
+
+bool spark_label_text_set(lv_obj_t* label, SparkLabelText* text, const char* function, const char* string) {
+    if (!string) string = "";
+    size_t size = strlen(string) + 1;
+    if (!reserve_text(text, size)) return false;
+    memcpy(text->next, string, size);
+    return apply_text(label, text, function);
+}
+
+// After the LVGL label is deleted
+void spark_label_text_free(SparkLabelText* text) {
+    free(text->shown);
+    free(text->next);
+    memset(text, 0, sizeof(SparkLabelText));
+}
+
 SparkLabel* spark_ui_label_new(const char* text, float x, float y, float width, float height) {
     SparkLabel* label = calloc(1, sizeof(SparkLabel));
     if (!label) {
@@ -49,7 +170,7 @@ SparkLabel* spark_ui_label_new(const char* text, float x, float y, float width,
     lv_obj_set_size(label->label, (lv_coord_t)width, (lv_coord_t)height);
 
     // Set the text
-    lv_label_set_text(label->label, text);
+    spark_label_text_set(label->label, &label->text, __func__, text);
 
     // Store coordinates
     label->x = x;
@@ -64,11 +185,20 @@ SparkLabel* spark_ui_label_new(const char* text, float x, float y, float width,
 
 void spark_ui_label_set_text(SparkLabel* label, const char* text) {
     if (!label || !label->label) return;
-    lv_label_set_text(label->label, text);
+    spark_label_text_set(label->label, &label->text, __func__, text);
+}
+
+void spark_ui_label_set_textf(SparkLabel* label, const char* format, ...) {
+    if (!label || !label->label || !format) return;
+    va_list args;
+    va_start(args, format);
+    spark_label_text_vset(label->label, &label->text, __func__, format, args);
+    va_end(args);
 }
 
 void spark_ui_label_set_position(SparkLabel* label, float x, float y) {
     if (!label || !label->label) return;
+    SPARK_TRACE_INVALIDATION(label->label);
     label->x = x;
     label->y = y;
     lv_obj_set_pos(label->label, (lv_coord_t)x, (lv_coord_t)y);
@@ -76,16 +206,37 @@ void spark_ui_label_set_position(SparkLabel* label, float x, float y) {
 
 void spark_ui_label_set_size(SparkLabel* label, float width, float height) {
     if (!label || !label->label) return;
+    SPARK_TRACE_INVALIDATION(label->label);
     label->width = width;
     label->height = height;
     lv_obj_set_size(label->label, (lv_coord_t)width, (lv_coord_t)height);
 }
 
+void spark_ui_label_set_font(SparkLabel* label, SparkFont* font) {
+    if (!label || !label->label || !label->style) return;
+    SPARK_TRACE_INVALIDATION(label->label);
+    lv_style_set_text_font(label->style, font ? spark_graphics_font_get_lv_font(font) : &lv_font_montserrat_14);
+    lv_obj_report_style_change(label->style);
+}
+
 const char* spark_ui_label_get_text(const SparkLabel* label) {
     if (!label || !label->label) return NULL;
     return lv_label_get_text(label->label);
 }
 
+// The current text in the label's font and spacing, through the measurement cache
+void spark_ui_label_get_text_size(const SparkLabel* label, float* width, float* height) {
+    int32_t w = 0, h = 0;
+    if (label && label->label) {
+        spark_graphics_measure_text(lv_label_get_text(label->label),
+                                    lv_obj_get_style_text_font(label->label, LV_PART_MAIN),
+                                    lv_obj_get_style_text_letter_space(label->label, LV_PART_MAIN),
+                                    lv_obj_get_style_text_line_space(label->label, LV_PART_MAIN),
+                                    0, &w, &h);
+    }
+    if (width) *width = (float)w;
+    if (height) *height = (float)h;
+}
 
 void spark_ui_label_free(SparkLabel* label) {
     if (!label) return;
@@ -98,5 +249,6 @@ void spark_ui_label_free(SparkLabel* label) {
         }
         lv_obj_del(label->label);
     }
+    spark_label_text_free(&label->text);
     free(label);
 }
\ No newline at end of file
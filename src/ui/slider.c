@@ -89,6 +89,7 @@ SparkSlider* spark_ui_slider_new(float x, float y, float width, float height) {
 
 void spark_ui_slider_set_range(SparkSlider* slider, float min, float max) {
     if (!slider || !slider->slider || min >= max) return;
+    SPARK_TRACE_INVALIDATION(slider->slider);
     slider->min_value = min;
     slider->max_value = max;
     
@@ -98,6 +99,7 @@ void spark_ui_slider_set_range(SparkSlider* slider, float min, float max) {
 
 void spark_ui_slider_set_value(SparkSlider* slider, float value) {
     if (!slider || !slider->slider) return;
+    SPARK_TRACE_INVALIDATION(slider->slider);
     
     // Map float value to LVGL's integer range
     float normalized = (value - slider->min_value) / (slider->max_value - slider->min_value);
@@ -113,6 +115,7 @@ void spark_ui_slider_set_callback(SparkSlider* slider, SparkSliderCallback callb
 
 void spark_ui_slider_set_step(SparkSlider* slider, float step) {
     if (!slider || !slider->slider) return;
+    SPARK_TRACE_INVALIDATION(slider->slider);
     slider->step = step;
     
     // Map step to LVGL integer range
@@ -122,6 +125,7 @@ void spark_ui_slider_set_step(SparkSlider* slider, float step) {
 
 void spark_ui_slider_set_position(SparkSlider* slider, float x, float y) {
     if (!slider || !slider->slider) return;
+    SPARK_TRACE_INVALIDATION(slider->slider);
     lv_obj_set_pos(slider->slider, (lv_coord_t)x, (lv_coord_t)y);
     slider->x = x;
     slider->y = y;
@@ -129,6 +133,7 @@ void spark_ui_slider_set_position(SparkSlider* slider, float x, float y) {
 
 void spark_ui_slider_set_size(SparkSlider* slider, float width, float height) {
     if (!slider || !slider->slider) return;
+    SPARK_TRACE_INVALIDATION(slider->slider);
     lv_obj_set_size(slider->slider, (lv_coord_t)width, (lv_coord_t)height);
     slider->width = width;
     slider->height = height;
@@ -136,6 +141,7 @@ void spark_ui_slider_set_size(SparkSlider* slider, float width, float height) {
 
 void spark_ui_slider_set_show_value(SparkSlider* slider, bool show) {
     if (!slider) return;
+    SPARK_TRACE_INVALIDATION(slider->slider);
     slider->show_value = show;
     
     if (show && !slider->value_label) {
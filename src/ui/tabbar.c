@@ -135,6 +135,7 @@ void spark_ui_tabbar_set_callback(SparkTabBar* tabbar, SparkTabCallback callback
 
 void spark_ui_tabbar_set_position(SparkTabBar* tabbar, float x, float y) {
     if (!tabbar || !tabbar->tabview) return;
+    SPARK_TRACE_INVALIDATION(tabbar->tabview);
     lv_obj_set_pos(tabbar->tabview, (lv_coord_t)x, (lv_coord_t)y);
     tabbar->x = x;
     tabbar->y = y;
@@ -142,6 +143,7 @@ void spark_ui_tabbar_set_position(SparkTabBar* tabbar, float x, float y) {
 
 void spark_ui_tabbar_set_size(SparkTabBar* tabbar, float width, float height) {
     if (!tabbar || !tabbar->tabview) return;
+    SPARK_TRACE_INVALIDATION(tabbar->tabview);
     lv_obj_set_size(tabbar->tabview, (lv_coord_t)width, (lv_coord_t)height);
     tabbar->width = width;
     tabbar->height = height;
@@ -161,6 +163,7 @@ void spark_ui_tabbar_get_size(SparkTabBar* tabbar, float* width, float* height)
 
 void spark_ui_tabbar_set_active_tab(SparkTabBar* tabbar, int index) {
     if (!tabbar || !tabbar->tabview) return;
+    SPARK_TRACE_INVALIDATION(tabbar->tabview);
     lv_tabview_set_active(tabbar->tabview, (uint32_t)index, LV_ANIM_ON);
 }
 